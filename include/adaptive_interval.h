@@ -0,0 +1,47 @@
+#ifndef ADAPTIVE_INTERVAL_H
+#define ADAPTIVE_INTERVAL_H
+
+#include <Arduino.h>
+
+// Stretch factor applied after each sample that did not move
+const float ADAPTIVE_INTERVAL_GROWTH = 1.5f;
+
+// Sampling/polling interval that follows the observed rate of change.
+//
+// Each sample that stays within the caller's threshold lengthens the interval
+// by ADAPTIVE_INTERVAL_GROWTH, up to maxIntervalMs; a sample that moves snaps
+// it back to minIntervalMs so the next change is caught quickly. Failed
+// samples also retry at the minimum. Every decision is logged together with
+// the number of samples taken versus what the fixed schedule would have taken.
+class AdaptiveInterval {
+private:
+    const char* name;
+    unsigned long fixedIntervalMs;
+    unsigned long minIntervalMs;
+    unsigned long maxIntervalMs;
+    unsigned long intervalMs;
+
+    unsigned long startTime;
+    unsigned long samples;
+    int stableStreak;
+
+    void logDecision(const char* reason);
+
+public:
+    AdaptiveInterval(const char* name, unsigned long fixedIntervalMs,
+                     unsigned long minIntervalMs, unsigned long maxIntervalMs);
+
+    unsigned long getInterval() const;
+
+    void recordSample(bool changed);
+    void recordFailure();
+
+    unsigned long getSampleCount() const;
+    unsigned long getFixedScheduleCount() const; // Samples the fixed interval would have taken
+    long getSavedCount() const;
+
+    // True when there is no previous value (NAN) or the value moved by at least threshold
+    static bool exceeds(float previous, float current, float threshold);
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef BOOT_SNAPSHOT_H
+#define BOOT_SNAPSHOT_H
+
+#include <Arduino.h>
+
+// NVS namespace holding the snapshots; survives resets and power loss like the panel image does
+#define BOOT_SNAPSHOT_NAMESPACE "snapshot"
+
+// Bump when a snapshot struct changes layout so old blobs are ignored
+const uint32_t BOOT_SNAPSHOT_FORMAT = 2;
+
+// Largest snapshot blob accepted (format word included)
+const size_t BOOT_SNAPSHOT_MAX_BYTES = 256;
+
+// Last-good data persisted in NVS so a reset can put it straight back on the
+// panel instead of a splash screen, plus a fingerprint of the image each panel
+// was last left showing (e-paper keeps it without power). Writes that would
+// store the same bytes again are skipped to spare the flash.
+class BootSnapshot {
+public:
+    // Copy a snapshot in or out; load() is false if none was saved with this
+    // size and BOOT_SNAPSHOT_FORMAT
+    static bool save(const char* key, const void* data, size_t size);
+    static bool load(const char* key, void* data, size_t size);
+
+    // 0 means the panel content is unknown
+    static uint32_t loadPanelFingerprint(int csPin);
+    static void savePanelFingerprint(int csPin, uint32_t fingerprint);
+
+    // 32-bit FNV-1a, never 0 so that value can mean "unknown"
+    static uint32_t fingerprint(const void* data, size_t length);
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef CLIMATE_LAYOUT_H
+#define CLIMATE_LAYOUT_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+struct TempHumidityData {
+    float temperature;
+    float humidity;
+    String lastUpdateTime;
+    bool sensorError;
+};
+
+// The temperature and humidity page (296x128 landscape): two columns. Split
+// into the constant chrome, rasterized once into the display's static layer,
+// and the readings drawn on top of it every frame. Depends only on
+// Adafruit_GFX so the host tests can render it.
+class ClimateLayout {
+public:
+    static void drawStatic(Adafruit_GFX* gfx);   // Header, rules and column labels
+    static void drawReadings(Adafruit_GFX* gfx, const TempHumidityData& data);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ENERGY_MONITOR_H
+#define ENERGY_MONITOR_H
+
+#include <Arduino.h>
+#include "telemetry_publisher.h"
+
+// Power states tracked by the energy model. CPU_ACTIVE is exclusive with idle
+// (everything else is idle); the other states add their current on top.
+enum class PowerState : uint8_t {
+    CPU_ACTIVE,
+    RADIO_ASSOCIATED,
+    RADIO_TRANSMITTING,
+    PANEL_FULL_REFRESH,
+    DHT_ACQUISITION,
+    COUNT
+};
+
+// Current figures in mA. Defaults are typical datasheet values for an
+// ESP32-WROVER at 240 MHz, an SSD1680 2.9" panel and a DHT11; measure your
+// own board and override them with EnergyMonitor::setPowerModel().
+struct PowerModel {
+    float idleMa = 30.0f;                 // CPU waiting in delay(), no light sleep
+    float cpuActiveMa = 50.0f;            // CPU busy
+    float radioAssociatedMa = 20.0f;      // Extra while associated (modem sleep average)
+    float radioTransmittingMa = 120.0f;   // Extra while a request is in flight
+    float panelFullRefreshMa = 8.0f;      // Extra during a full waveform
+    float dhtAcquisitionMa = 1.5f;        // Extra during a DHT read
+};
+
+// Records time spent in each power state and turns it into an estimated
+// charge consumption. Safe to call from any task.
+class EnergyMonitor {
+public:
+    static void begin();
+    static void setPowerModel(const PowerModel& model);
+
+    // Nested enter/exit pairs are counted, so overlapping users of a state are fine
+    static void enter(PowerState state);
+    static void exit(PowerState state);
+    static void setActive(PowerState state, bool active); // For level states like RADIO_ASSOCIATED
+
+    static float getConsumedMah();
+    static float getAverageMa();
+    static float getProjectedMahPerDay();
+
+    static void printReport();
+    static void publish(TelemetryPublisher& telemetry);
+
+private:
+    static void accumulate(int64_t now);
+    static float stateCurrentMa(PowerState state);
+    static const char* stateName(PowerState state);
+};
+
+// Counts the enclosing scope as time spent in a power state
+class EnergyScope {
+public:
+    explicit EnergyScope(PowerState scopeState) : state(scopeState) { EnergyMonitor::enter(state); }
+    ~EnergyScope() { EnergyMonitor::exit(state); }
+
+private:
+    PowerState state;
+};
+
+#endif
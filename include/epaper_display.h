@@ -5,11 +5,50 @@
 #include <GxEPD2_BW.h>
 #include <Adafruit_GFX.h>
 #include <Fonts/FreeMonoBold12pt7b.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+#include "frame_buffer.h"
+#include "text_metrics.h"
+
+typedef GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> EpdDriver;
+
+// Upper bound for a full refresh of the 2.9" panel, used when waiting for completion
+const unsigned long EPD_REFRESH_TIMEOUT_MS = 10000;
 
 class EPaperDisplay {
 private:
-    GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT>* display;
+    EpdDriver* display;
+    bool driverInternal;  // In MemoryReport's internal block (placement new), else from plain new
     int csPin, dcPin, rstPin, busyPin;
+
+    // Frames are rendered here and written to the controller as one image
+    uint8_t frameStorage[FrameBuffer::BUFFER_SIZE];
+    FrameBuffer frame;
+
+    // Fingerprint of the image on the panel, kept in NVS because e-paper holds
+    // it across resets and power loss; 0 when unknown (drawn outside the frame)
+    uint32_t shownFingerprint;
+
+    // Constant chrome (rules, labels) rasterized once and copied into each frame
+    uint8_t* staticLayer;
+    bool staticLayerValid;
+
+    // Async refresh: a background task pushes the frame and sleeps on the
+    // BUSY-pin edge interrupt instead of busy-waiting on the calling core
+    bool asyncRefresh;
+    TaskHandle_t refreshTask;
+    SemaphoreHandle_t busySignal;     // Given by the BUSY falling-edge ISR
+    EventGroupHandle_t refreshEvents; // REFRESH_IDLE_BIT set while no refresh is running
+
+    static void IRAM_ATTR onBusyEdge(void* arg);
+    static void waitForBusyEdge(const void* arg);
+    static void refreshTaskEntry(void* arg);
+    void refreshLoop();
+    void pushFrame();
+    void prepareFrame(bool useStaticLayer);
+    void forgetShownFrame();
     
 public:
     EPaperDisplay(int cs, int dc, int rst, int busy);
@@ -28,7 +67,30 @@ public:
     void drawText(const char* text, int x, int y, int textSize = 1);
     void drawLine(int x1, int y1, int x2, int y2);
     void finishUpdate();
-    int getTextWidth(const char* text, int textSize = 1);
+    int getTextWidth(const char* text, int textSize = 1);       // Built-in font, no side effects
+    int getTextWidth(const char* text, const GFXfont* font, int textSize = 1); // Variable-width fonts
+
+    // Frame rendering: beginFrame() returns a cleared landscape canvas, endFrame()
+    // pushes it to the panel (in the background when async refresh is enabled).
+    // With useStaticLayer the canvas starts as a copy of the static layer.
+    // A frame identical to the one already showing is not refreshed again.
+    Adafruit_GFX* beginFrame(bool useStaticLayer = false);
+    void endFrame();
+
+    // Static layer: draw the constant parts once between begin/endStaticLayer()
+    Adafruit_GFX* beginStaticLayer();
+    void endStaticLayer();
+    bool hasStaticLayer() const;
+    void invalidateStaticLayer();
+
+    // Offscreen rendering: prepare any canvas like beginFrame() does, and push a
+    // frame rendered earlier without drawing anything on the refresh path
+    void prepareCanvas(FrameBuffer& canvas, bool useStaticLayer);
+    void showFrame(const uint8_t* image);
+    void setAsyncRefresh(bool enabled);
+    bool isRefreshing() const;
+    bool waitForRefresh(unsigned long timeoutMs = EPD_REFRESH_TIMEOUT_MS);
+    uint32_t getShownFingerprint() const;
     GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT>* getDisplay(); // Direct access for advanced drawing
 };
 
@@ -0,0 +1,65 @@
+#ifndef FETCH_POLICY_H
+#define FETCH_POLICY_H
+
+#include <Arduino.h>
+
+// Per-request limits handed to HTTPClient, so a hung server cannot stall the loop
+const int32_t FETCH_CONNECT_TIMEOUT_MS = 5000;
+const uint16_t FETCH_READ_TIMEOUT_MS = 8000;
+
+// Retry delay after a failure: base * 2^(failures - 1), capped, with jitter
+const unsigned long FETCH_BACKOFF_BASE_MS = 2000;
+const unsigned long FETCH_BACKOFF_MAX_MS = 30000;
+
+// Consecutive failures that open the circuit, and how long it stays open
+// before a single probe is let through. A failed probe doubles the cooldown.
+const int FETCH_BREAKER_THRESHOLD = 4;
+const unsigned long FETCH_BREAKER_COOLDOWN_MS = 300000;      // 5 minutes
+const unsigned long FETCH_BREAKER_MAX_COOLDOWN_MS = 1800000; // 30 minutes
+
+enum class CircuitState : uint8_t { CLOSED, OPEN, HALF_OPEN };
+
+// Retry and circuit-breaker policy for a remote data source.
+//
+// While closed, every failure schedules a retry with exponential backoff;
+// half of each delay is random so devices that failed together do not retry
+// together. FETCH_BREAKER_THRESHOLD failures in a row open the circuit: no
+// requests are made (the caller keeps serving its last good data) until the
+// cooldown has passed, then one probe decides whether it closes again.
+class FetchPolicy {
+private:
+    const char* name;
+    CircuitState state;
+    int consecutiveFailures;
+    unsigned long openedAt;
+    unsigned long cooldownMs;
+    unsigned long retryDelayMs;
+
+    unsigned long attempts;
+    unsigned long failures;
+    unsigned long suppressed;   // Requests skipped because the circuit was open
+
+    void open(unsigned long now);
+    void logDecision(const char* reason) const;
+
+public:
+    FetchPolicy(const char* name);
+
+    // True if a request may be made now; moves an open circuit to half-open
+    // once its cooldown has elapsed
+    bool allowRequest(unsigned long now);
+    void recordSuccess();
+    void recordFailure(unsigned long now);
+
+    CircuitState getState() const;
+    const char* getStateName() const;
+    int getConsecutiveFailures() const;
+    unsigned long getRetryDelay() const;                   // Chosen at the last failure while closed
+    unsigned long getTimeUntilProbe(unsigned long now) const; // 0 unless the circuit is open
+
+    unsigned long getAttemptCount() const;
+    unsigned long getFailureCount() const;
+    unsigned long getSuppressedCount() const;
+};
+
+#endif
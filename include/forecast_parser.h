@@ -0,0 +1,114 @@
+#ifndef FORECAST_PARSER_H
+#define FORECAST_PARSER_H
+
+// Parsing and aggregation of Open-Meteo marine responses, in either the JSON
+// or the FlatBuffers format. Deliberately free of Arduino dependencies (only
+// ArduinoJson and the C library) so the same code can be built and exercised
+// on a host machine.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+
+// Aggregation windows, in hours from the first forecast point
+const int FORECAST_TODAY_START_HOUR = 1;
+const int FORECAST_TODAY_END_HOUR = 12;
+const int FORECAST_TOMORROW_START_HOUR = 24;
+const int FORECAST_TOMORROW_END_HOUR = 36;
+
+// Wave heights in metres. A window with no usable points reports 0.
+struct ForecastSummary {
+    float currentHeight;      // First non-null point
+    float todayAverage;
+    float tomorrowAverage;
+    int hours;                // Points in the hourly series
+    int nullHours;            // Points skipped because they were null
+};
+
+// Optional per-hour output for callers that look at individual hours.
+// The caller owns heights; points beyond capacity are dropped.
+struct ForecastSeries {
+    float* heights;           // Metres, NAN for null points
+    int capacity;
+    int count;                // Points written
+    int64_t startTime;        // Epoch seconds of the first point, 0 if the response had none
+};
+
+// ArduinoJson allocator that counts allocations and tracks peak usage, so
+// each parse can report what it cost. Each block carries a small size header.
+class CountingAllocator : public ArduinoJson::Allocator {
+public:
+    CountingAllocator(ArduinoJson::Allocator* upstream = nullptr);
+
+    void* allocate(size_t size) override;
+    void deallocate(void* pointer) override;
+    void* reallocate(void* pointer, size_t newSize) override;
+
+    void reset();
+    size_t getAllocationCount() const { return allocations; }
+    size_t getPeakBytes() const { return peakBytes; }
+    size_t getCurrentBytes() const { return currentBytes; }
+
+private:
+    ArduinoJson::Allocator* upstream; // Defaults to malloc/free
+    size_t allocations;
+    size_t currentBytes;
+    size_t peakBytes;
+
+    void track(size_t size);
+};
+
+// A [float] vector read in place from a FlatBuffers message. Missing values
+// are encoded as NaN.
+struct FlatFloatVector {
+    const uint8_t* data;
+    size_t count;
+
+    float at(size_t index) const;
+};
+
+class ForecastParser {
+public:
+    // Parse a response body, allocating the JSON document through allocator.
+    // A multi-location response (a JSON array) is indexed by locationIndex.
+    // Returns false with a static message in *error for invalid or truncated
+    // JSON and for responses without wave data. With series set, the hourly
+    // points are copied out too (start time needs timeformat=unixtime).
+    static bool parse(const char* json, size_t length, ForecastSummary& summary,
+                      const char** error, ArduinoJson::Allocator* allocator,
+                      int locationIndex = 0, ForecastSeries* series = nullptr);
+
+    // Same as parse(), reading from any ArduinoJson reader (a Stream, or any
+    // type with read() and readBytes()) so the body never has to be buffered
+    template <typename TReader>
+    static bool parseStream(TReader& input, ForecastSummary& summary, const char** error,
+                            ArduinoJson::Allocator* allocator, int locationIndex = 0,
+                            ForecastSeries* series = nullptr) {
+        JsonDocument doc(allocator);
+        return interpret(deserializeJson(doc, input), doc, summary, error, locationIndex, series);
+    }
+
+    // Parse a format=flatbuffers response: one size-prefixed WeatherApiResponse
+    // per location, with wave_height as the only requested hourly variable.
+    // The series is read straight out of data; nothing is copied or allocated.
+    static bool parseFlatBuffer(const uint8_t* data, size_t length, ForecastSummary& summary,
+                                const char** error, int locationIndex = 0, ForecastSeries* series = nullptr);
+
+    // Mean of the non-null points in [startHour, endHour); 0 if there are none
+    static float averageHeight(JsonArrayConst heights, int startHour, int endHour);
+    static float averageHeight(const FlatFloatVector& heights, int startHour, int endHour);
+
+    static bool summarize(JsonArrayConst heights, ForecastSummary& summary);
+    static bool summarize(const FlatFloatVector& heights, ForecastSummary& summary);
+
+    // How SurfConditions shows a height: in feet, rated FLAT, SMALL, GOOD,
+    // GREAT, EPIC or HUGE
+    static float metersToFeet(float meters);
+    static const char* getRating(float heightMeters);
+
+private:
+    static bool interpret(DeserializationError result, const JsonDocument& doc, ForecastSummary& summary,
+                          const char** error, int locationIndex, ForecastSeries* series);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <GxEPD2_BW.h>
+
+// 1-bpp frame in the panel's native portrait layout (bit set = white).
+// Byte layout and rotation mapping match GxEPD2_BW's own buffer exactly, so a
+// frame can be written straight to the controller with epd2.writeImage() and
+// copied around with memcpy. The storage (BUFFER_SIZE bytes) is owned by the
+// caller, which decides where it lives (internal RAM, PSRAM, ...).
+//
+// Lines, rectangles and built-in font text are rasterized as byte-wide spans
+// straight into the buffer instead of through Adafruit_GFX's per-pixel
+// fallbacks, with pixel-identical results (test/test_frame_buffer).
+class FrameBuffer : public Adafruit_GFX {
+public:
+    static const int16_t NATIVE_WIDTH = GxEPD2_290_BS::WIDTH;   // 128
+    static const int16_t NATIVE_HEIGHT = GxEPD2_290_BS::HEIGHT; // 296
+    static const size_t BUFFER_SIZE = (NATIVE_WIDTH / 8) * NATIVE_HEIGHT;
+
+    explicit FrameBuffer(uint8_t* storage);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    using Adafruit_GFX::write;
+    size_t write(uint8_t c) override;
+
+    uint8_t* getBuffer();
+    const uint8_t* getBuffer() const;
+    void copyFrom(const uint8_t* source); // Replace the whole frame
+    void copyTo(uint8_t* destination) const;
+    // Start a page: the given background (or white if null), landscape
+    // rotation, black built-in font at size 1
+    void beginPage(const uint8_t* background);
+
+private:
+    uint8_t* buffer;
+
+    void fillNative(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawGlyph(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                   uint8_t sizeX, uint8_t sizeY);
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <esp32/rom/miniz.h>
+
+// Compressed input is pulled from the source in chunks of this size
+const size_t INFLATE_INPUT_CHUNK = 512;
+// Give up when the source stays silent this long
+const unsigned long INFLATE_READ_TIMEOUT_MS = 5000;
+
+// Read-only Stream that inflates a gzip body on the fly from a Client
+// (e.g. the HTTPClient connection), so a parser can consume it without the
+// whole body ever being buffered. Uses the miniz inflater in the ESP32 ROM.
+//
+// Deflate back-references reach up to 32 KB, so the output window is fixed
+// at TINFL_LZ_DICT_SIZE; it and the inflater state live in PSRAM. With
+// gzip = false the source is passed through unchanged and only counted.
+class InflateStream : public Stream {
+public:
+    InflateStream(Client& source, bool gzip);
+    ~InflateStream();
+
+    bool begin(); // Allocates the window; false if out of memory
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    size_t write(uint8_t) override { return 0; }
+
+    size_t getCompressedBytes() const { return compressedBytes; }  // Read from the source
+    size_t getInflatedBytes() const { return inflatedBytes; }      // Handed to the reader
+    bool hasError() const { return error; }
+
+private:
+    enum HeaderState : uint8_t { FIXED, EXTRA_LENGTH, EXTRA, NAME, COMMENT, HEADER_CRC, DEFLATE };
+
+    Client& source;
+    bool gzip;
+    bool finished;
+    bool error;
+    bool moreOutput;          // Last inflate call stopped because the window was full
+
+    tinfl_decompressor* inflater;
+    uint8_t* window;          // Circular output window of TINFL_LZ_DICT_SIZE bytes
+    size_t windowPos;         // Where the next inflate call writes
+    const uint8_t* output;    // Bytes not yet read: window when inflating, input when passing through
+    size_t outPos, outEnd;
+
+    uint8_t input[INFLATE_INPUT_CHUNK];
+    size_t inPos, inEnd;
+
+    HeaderState headerState;
+    uint8_t headerFlags;
+    size_t headerCount;       // Bytes seen in the current header state
+    size_t extraLength;
+
+    size_t compressedBytes;
+    size_t inflatedBytes;
+
+    bool readSource();
+    bool fill();
+    bool skipHeader();
+    void advanceHeader();
+};
+
+#endif
@@ -2,19 +2,74 @@
 #define LED_CONTROLLER_H
 
 #include <Arduino.h>
+#include <driver/ledc.h>
+#include <esp_timer.h>
 
+// LEDC resources for the status LED, kept clear of the high-speed channels
+// the Arduino core hands out first
+const ledc_mode_t LED_LEDC_MODE = LEDC_LOW_SPEED_MODE;
+const ledc_timer_t LED_LEDC_TIMER = LEDC_TIMER_3;
+const ledc_channel_t LED_LEDC_CHANNEL = LEDC_CHANNEL_7;
+const uint32_t LED_PWM_FREQUENCY_HZ = 5000;
+const ledc_timer_bit_t LED_PWM_RESOLUTION = LEDC_TIMER_13_BIT;
+const uint32_t LED_MAX_DUTY = (1 << 13) - 1;
+
+// What the LED is signalling; each status has a pattern in led_controller.cpp
+enum class LedStatus : uint8_t {
+    OFF,
+    ON,            // Solid
+    BOOTING,       // Fast blink
+    OK,            // Slow breathing
+    WIFI_DOWN,     // Blink code: 2 pulses
+    SENSOR_ERROR,  // Blink code: 3 pulses
+    STALE_DATA,    // Blink code: 1 long pulse
+    ALERT,         // Fast breathing, while an alert rule is active
+    COUNT
+};
+
+// One step of a pattern: go to level (percent of full brightness), fading
+// over durationMs or switching at once, and hold until durationMs has passed.
+// A duration of 0 ends the pattern with the LED left at that level.
+struct LedStep {
+    uint8_t level;
+    bool fade;
+    uint16_t durationMs;
+};
+
+// Status LED on the LEDC peripheral. Patterns are stepped by an esp_timer
+// callback and fades run in the LEDC hardware, so callers only post status
+// changes: nothing touches the pin or the serial port in between.
 class LEDController {
 private:
     int pin;
-    bool state;
-    
+    bool ready;
+    LedStatus status;
+
+    // Pattern being played; guarded by mux since the timer callback reads it
+    const LedStep* steps;
+    uint8_t stepCount;
+    uint8_t stepIndex;
+    bool repeat;             // false for a one-off flash, which then resumes the status pattern
+    bool timerArmed;         // A step is in progress and the timer will fire at its end
+    LedStep flashSteps[2];
+    esp_timer_handle_t timer;
+    portMUX_TYPE mux;
+
+    static void onTimer(void* arg);
+    void playNextStep();
+    void play(const LedStep* pattern, uint8_t count, bool loop);
+    void playStatus();
+
 public:
     LEDController(int ledPin);
     void begin();
+    void setStatus(LedStatus newStatus); // Cheap to call every loop; only changes are acted on
+    LedStatus getStatus() const;
+    static const char* getStatusName(LedStatus status);
     void on();
     void off();
     void toggle();
-    void flash(int delayMs = 1000);
+    void flash(int delayMs = 1000); // One pulse, then back to the status pattern; returns at once
     bool getState() const;
 };
 
@@ -0,0 +1,89 @@
+#ifndef LOCATION_CATALOG_H
+#define LOCATION_CATALOG_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+// Data partition holding the catalog (see partitions.csv and tools/build_location_catalog.py)
+#define LOCATION_CATALOG_PARTITION "catalog"
+
+const uint16_t LOCATION_CATALOG_VERSION = 1;
+
+struct SurfLocation {
+    float latitude;
+    float longitude;
+    const char* name;         // Points into mapped flash or rodata; never freed
+};
+
+// On-flash layout, little-endian. Spots are sorted by grid cell and each
+// cell record points at its run of spots, so a lookup touches only the
+// cells around the position. Names are NUL-terminated in one string table.
+struct CatalogHeader {
+    char magic[4];            // "SPOT"
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t totalSize;       // Bytes including this header
+    uint32_t spotCount;
+    uint32_t cellCount;
+    float cellSize;           // Degrees of latitude and longitude per grid cell
+    uint32_t cellsOffset;
+    uint32_t spotsOffset;
+    uint32_t namesOffset;
+    uint32_t namesSize;
+    uint32_t checksum;        // FNV-1a of everything after the header
+};
+
+struct CatalogCell {
+    uint32_t key;             // row * columns + column, rows counted from -90, columns from -180
+    uint32_t firstSpot;
+    uint32_t spotCount;
+};
+
+struct CatalogSpot {
+    float latitude;
+    float longitude;
+    uint32_t nameOffset;      // Into the string table
+};
+
+// Read-only catalog of surf spots, used in place from memory-mapped flash:
+// nothing is copied to RAM, and callers hold spot indices. Without a valid
+// catalog partition it serves the built-in spots instead.
+class LocationCatalog {
+private:
+    const CatalogHeader* header;
+    const CatalogCell* cells;
+    const CatalogSpot* spots;
+    const char* names;
+    uint32_t rows, columns;
+    spi_flash_mmap_handle_t mapping;
+    bool mapped;
+
+    const CatalogCell* findCell(uint32_t key) const;
+    uint32_t rowOf(float latitude) const;
+    uint32_t columnOf(float longitude) const;
+
+public:
+    LocationCatalog();
+    ~LocationCatalog();
+
+    // Map and validate the catalog partition; false leaves the built-in spots
+    bool begin();
+    void end();
+
+    // Use a catalog image already in memory (validated the same way)
+    bool attach(const uint8_t* image, size_t length);
+
+    bool isMapped() const;
+    uint32_t size() const;
+    SurfLocation get(uint32_t index) const;
+
+    // Indices of the count spots closest to a position, nearest first, with
+    // their great-circle distances if distancesKm is set (count is capped at
+    // 16 without it). Returns how many were found.
+    int findNearest(float latitude, float longitude, int count, uint32_t* indices,
+                    float* distancesKm = nullptr) const;
+
+    static float distanceKm(float latitude1, float longitude1, float latitude2, float longitude2);
+};
+
+#endif
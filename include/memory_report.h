@@ -0,0 +1,41 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+const int MEMORY_REPORT_MAX_BUFFERS = 32;
+const int MEMORY_REPORT_MAX_TASKS = 8;
+
+// Where a buffer should live. INTERNAL is for anything touched from an ISR,
+// by DMA or on a latency-sensitive path; PSRAM is for bulk data that is only
+// copied or parsed (falls back to internal RAM on boards without PSRAM).
+enum class MemoryPlacement : uint8_t {
+    INTERNAL,
+    PSRAM,
+    STATIC   // Lives in .bss/.data or inside another object; registered for reporting only
+};
+
+// Explicit placement of large buffers plus a runtime memory report: heap and
+// PSRAM usage, minimum-free watermarks, per-subsystem buffer totals and task
+// stack high-water marks.
+class MemoryReport {
+public:
+    // Allocate and register a buffer. Returns nullptr if it does not fit.
+    static void* allocate(const char* subsystem, const char* name, size_t bytes, MemoryPlacement placement);
+    static void* reallocate(void* pointer, size_t bytes);
+    static void release(void* pointer);
+
+    // Record a buffer that was not allocated through allocate()
+    static void registerBuffer(const char* subsystem, const char* name, const void* pointer,
+                               size_t bytes, MemoryPlacement placement);
+    static void registerTask(TaskHandle_t task);
+
+    static void print();
+
+private:
+    static const char* placementName(MemoryPlacement placement);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef PANEL_GROUP_H
+#define PANEL_GROUP_H
+
+#include <Arduino.h>
+#include "epaper_display.h"
+
+const int MAX_PANELS = 4;
+
+// Several e-paper panels on one SPI bus and DC line, each with its own CS, RST
+// and BUSY pins. Every panel refreshes from its own background task, and a
+// panel holding BUSY during its waveform leaves the bus free, so the next
+// panel's image is sent meanwhile: N panels cost one waveform plus N image
+// transfers instead of N full refreshes.
+class PanelGroup {
+private:
+    EPaperDisplay* panels[MAX_PANELS];
+    bool pending[MAX_PANELS];    // Frame drawn but not committed yet
+    int panelCount;
+    unsigned long commitStart;   // millis() of the first commit since the group was idle
+
+    void noteCommit();
+
+public:
+    PanelGroup();
+
+    bool add(EPaperDisplay* panel); // Before begin(); false when the group is full
+    void begin();                   // Initializes every panel with async refresh enabled
+
+    int getPanelCount() const;
+    EPaperDisplay* getPanel(int index);
+
+    // Draw a frame for one panel (only waits for that panel's own refresh);
+    // it is sent by commit() or commitAll(). An index out of range gets
+    // nullptr here and is ignored by commit() and showFrame().
+    Adafruit_GFX* beginFrame(int index, bool useStaticLayer = false);
+    void commit(int index);
+    void commitAll();
+    void showFrame(int index, const uint8_t* image); // Push a pre-rendered frame right away
+
+    bool isRefreshing() const;
+    bool waitAll(unsigned long timeoutMs = EPD_REFRESH_TIMEOUT_MS);
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef RULE_ENGINE_H
+#define RULE_ENGINE_H
+
+#include <Arduino.h>
+
+const int RULE_MAX_RULES = 8;
+const int RULE_MAX_KEYS = 16;          // Independent states per rule, e.g. one per surf spot
+const int RULE_WINDOW_BUCKETS = 4;     // Resolution of rise/fall windows (a third of the window)
+const int RULE_TEXT_LENGTH = 96;       // Longest rule accepted by compile()
+
+// What a rule can watch; a sample carries any subset of them
+enum class RuleSignal : uint8_t {
+    TEMPERATURE,   // °C
+    HUMIDITY,      // % RH
+    WAVE_HEIGHT,   // ft
+    SURF_RATING,   // FLAT=0 SMALL GOOD GREAT EPIC HUGE=5
+    COUNT
+};
+
+enum class RuleKind : uint8_t {
+    ABOVE_FOR,     // "humidity > 70 for 2h"
+    BELOW_FOR,     // "temperature < 5 for 30m"
+    RISES_WITHIN,  // "temperature rises 3 within 1h"
+    FALLS_WITHIN,  // "humidity falls 10 within 15m"
+    CHANGES_TO     // "rating SMALL -> GREAT": at or above GREAT after being at or below SMALL
+};
+
+// Where an alert goes; a rule lists any of them after "=>"
+const uint8_t RULE_ACTION_LED = 1 << 0;      // "led": alert LED pattern while active
+const uint8_t RULE_ACTION_DISPLAY = 1 << 1;  // "display": alert page on the panel
+const uint8_t RULE_ACTION_HOOK = 1 << 2;     // "hook": outbound event (telemetry)
+
+// A rule after compile(): fixed size, no strings to parse on the sample path
+struct CompiledRule {
+    const char* text;       // Source, for logs and events; must outlive the engine
+    float threshold;        // Level, rise/fall amount, or rating changed to
+    float from;             // CHANGES_TO: rating changed from
+    uint32_t windowMs;      // Hold time or rise/fall window
+    RuleSignal signal;
+    RuleKind kind;
+    uint8_t actions;
+};
+
+// Per rule and key; everything a rule needs to decide from the next sample alone
+struct RuleState {
+    unsigned long since;    // Condition holding since (ABOVE/BELOW), or current bucket start (windows)
+    float lowest[RULE_WINDOW_BUCKETS]; // Lowest value per bucket; falls are stored negated
+    uint8_t bucket;
+    bool holding;           // Condition holding (ABOVE/BELOW), window primed, or change armed
+    bool active;            // Alert raised and not yet cleared
+};
+
+// One value per RuleSignal, NAN where the sample has none
+struct RuleSample {
+    float values[(int)RuleSignal::COUNT];
+
+    RuleSample() {
+        for (int i = 0; i < (int)RuleSignal::COUNT; i++) values[i] = NAN;
+    }
+    void set(RuleSignal signal, float value) { values[(int)signal] = value; }
+};
+
+// An alert raised (active) or cleared for one key
+struct RuleEvent {
+    int rule;
+    const CompiledRule* compiled;
+    uint8_t key;
+    const char* label;      // Caller's name for the key, e.g. the surf spot
+    float value;
+    bool active;
+};
+
+typedef void (*RuleHandler)(const RuleEvent& event);
+
+// Threshold and alert rules evaluated incrementally on each sample.
+//
+// Rules are written as text ("humidity > 70 for 2h => led display") and
+// compiled once into CompiledRule records. Each sample then costs one pass
+// over the rules, with constant-time state per rule and key: a start time for
+// hold rules, a ring of per-bucket minimums for rise/fall windows (so a window
+// reaches back between windowMs and a third more), and an armed flag for
+// changes. Nothing rescans history. Rules judge what was sampled; a level that
+// dipped between two samples is not seen.
+//
+// Alerts are edge-triggered: the handler gets one event when a rule becomes
+// active for a key and one when it clears (a rise or fall once it is back
+// under half the amount). Evaluation cost is timed per sample
+// and logged, with totals in printStats().
+class RuleEngine {
+private:
+    CompiledRule rules[RULE_MAX_RULES];
+    int ruleCount;
+    RuleState* states;      // ruleCount x keyCount, allocated by compile()
+    int keyCount;
+    RuleHandler handler;
+
+    unsigned long samples;
+    unsigned long totalUs;
+    unsigned long maxUs;
+    unsigned long alertsRaised;
+
+    static bool parse(const char* text, CompiledRule& rule, const char** error);
+    static bool step(const CompiledRule& rule, RuleState& state, float value, unsigned long now);
+    void resetState(RuleState& state);
+
+public:
+    RuleEngine();
+    ~RuleEngine();
+
+    // Compile the rules and size their state for keys independent keys. Rules
+    // that do not parse are logged and left out; false if any were.
+    bool compile(const char* const* texts, int count, int keys = 1);
+    void setHandler(RuleHandler newHandler);
+
+    // Evaluate every rule whose signal the sample carries, for one key
+    void evaluate(int key, const char* label, const RuleSample& sample, unsigned long now);
+
+    // Forget all history and clear alerts (silently), e.g. when keys are reassigned
+    void reset();
+
+    int getRuleCount() const;
+    bool isAlertActive(uint8_t actions) const; // Any rule with one of these actions active for any key
+    void printStats() const;
+
+    static const char* getSignalName(RuleSignal signal);
+    static int ratingLevel(const char* rating); // FLAT=0 ... HUGE=5, -1 if unknown
+    static const char* getRatingName(int level);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define SENSOR_INTERFACE_H
 
 #include <Arduino.h>
+#include <limits.h>
 #include "epaper_display.h"
 
 class SensorInterface {
@@ -14,6 +15,22 @@ public:
     virtual void displayCurrentData() = 0;
     virtual bool isDataReady() const = 0;
 
+    // Health for the status LED; sensors that cannot tell keep the defaults
+    virtual bool hasError() const { return false; }    // Last reading/fetch failed
+    virtual bool isDataStale() const { return false; } // Shown data is older than it should be
+
+    // Milliseconds until update() next has work to do (0 = now), so the main
+    // loop can sleep until then; sensors that cannot tell leave it to the loop
+    virtual unsigned long getTimeUntilUpdate(unsigned long now) const { return ULONG_MAX; }
+
+    // Put the last good data saved before a reset back on the panel, ahead of
+    // begin(); false if there is none and a splash screen should be shown instead
+    virtual bool restoreSnapshot() { return false; }
+
+    // Something else (an alert page) was drawn over the sensor's panel, so the
+    // next displayCurrentData() must redraw it even if the data is unchanged
+    virtual void invalidateDisplay() {}
+
     // Optional: deployment-specific methods can be added by subclasses
 };
 
@@ -0,0 +1,62 @@
+#ifndef SESSION_RANKER_H
+#define SESSION_RANKER_H
+
+// Scores every (location, hour) of the forecast horizon against configurable
+// criteria and keeps the best upcoming sessions. Like the forecast parser it
+// only needs the C library, so it can be exercised on a host machine.
+
+#include <stddef.h>
+#include <stdint.h>
+
+const int SESSION_MAX_LOCATIONS = 16;
+const int SESSION_MAX_HOURS = 168;      // 7 days of hourly points
+const int SESSION_TOP_K = 5;            // Sessions kept per location and overall
+const int SESSION_MIN_GAP_HOURS = 3;    // Picks from one spot are at least this far apart
+
+// What makes a good session. Heights in metres, hours in local time.
+struct SessionCriteria {
+    float idealMinHeight;   // Full score inside [idealMinHeight, idealMaxHeight]
+    float idealMaxHeight;
+    float heightTolerance;  // Score falls linearly to 0 this far outside the band
+    int daylightStartHour;  // Hours outside [start, end) are never sessions
+    int daylightEndHour;
+};
+
+struct Session {
+    int location;
+    int64_t time;           // Epoch seconds at the start of the hour
+    float waveHeight;       // Metres
+    float score;            // 0-100
+};
+
+class SessionRanker {
+public:
+    SessionRanker();
+
+    // Replacing the criteria drops every candidate; each location is ranked
+    // again when its next forecast arrives
+    void setCriteria(const SessionCriteria& newCriteria);
+    const SessionCriteria& getCriteria() const { return criteria; }
+
+    // Rescore one location from its hourly series (NAN = missing point).
+    // Only that location's candidates change; hours before now are ignored.
+    void update(int location, const float* heights, int count, int64_t startTime, int64_t now);
+    void clear(int location);
+
+    // Best sessions that have not ended yet, best first; returns how many
+    int getTopSessions(Session* out, int k, int64_t now) const;
+
+    // 0 for hours outside daylight or too far outside the height band
+    float scoreHour(float height, int64_t time) const;
+
+    // Cost of the last update()
+    int getLastScoredHours() const { return lastScoredHours; }
+
+private:
+    SessionCriteria criteria;
+    Session candidates[SESSION_MAX_LOCATIONS][SESSION_TOP_K]; // Best first
+    int candidateCount[SESSION_MAX_LOCATIONS];
+    int lastScoredHours;
+};
+
+#endif
@@ -6,63 +6,161 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include "epaper_display.h"
+#include "panel_group.h"
 #include "sensor_interface.h"
+#include "telemetry_publisher.h"
+#include "adaptive_interval.h"
+#include "fetch_policy.h"
+#include "forecast_parser.h"
+#include "session_ranker.h"
+#include "location_catalog.h"
+#include "rule_engine.h"
+#include "surf_layout.h"
 
 // Global refresh interval for both data fetch and display update (in milliseconds)
 const unsigned long REFRESH_INTERVAL_MS = 60000; // 1 minute
 
-struct SurfLocation {
-    float latitude;
-    float longitude;
-    String name;
-};
+// Adaptive polling: a location's forecast is re-fetched once it is older than the
+// current polling interval, which stretches towards this bound while wave heights are flat
+const unsigned long FORECAST_MAX_AGE_MS = 3600000; // 1 hour (the API's data is hourly)
+const float WAVE_HEIGHT_CHANGE_FT = 0.5f;          // Movement that snaps polling back to every visit
+// No successful fetch for this long marks the data stale
+const unsigned long FORECAST_STALE_MS = 2 * FORECAST_MAX_AGE_MS;
+
+// Best-session ranking: full score for heights inside the band, falling to zero
+// SESSION_HEIGHT_TOLERANCE_FT outside it. Only daylight hours (local) count.
+const float SESSION_IDEAL_MIN_FT = 2.0f;
+const float SESSION_IDEAL_MAX_FT = 6.0f;
+const float SESSION_HEIGHT_TOLERANCE_FT = 2.0f;
+const int SESSION_DAYLIGHT_START_HOUR = 7;
+const int SESSION_DAYLIGHT_END_HOUR = 19;
+
+// Wire format requested from the API. FLATBUFFERS reads the wave series in place
+// from the receive buffer with no document; COMPARE alternates between the two on
+// successive fetches and buffers both, so the log shows their parse cost side by side.
+enum class ForecastFormat : uint8_t { JSON, FLATBUFFERS, COMPARE };
+const ForecastFormat FORECAST_FORMAT = ForecastFormat::JSON;
+
+// Receive buffer for buffered ingest; doubles as needed up to the maximum
+const size_t FORECAST_BODY_INITIAL_BYTES = 2048;
+const size_t FORECAST_BODY_MAX_BYTES = 65536;
+
+// Marine API endpoint; override with -DFORECAST_API_URL=\"http://host:port/v1/marine\"
+// to point the device at a stand-in server (see tools/marine_api_standin.py)
+#ifndef FORECAST_API_URL
+#define FORECAST_API_URL "https://marine-api.open-meteo.com/v1/marine"
+#endif
 
-struct SurfConditions {
-    float currentWaveHeight;
-    float todayAverage;
-    float tomorrowAverage;
-    String currentRating;
-    String todayRating;
-    String tomorrowRating;
-    String currentTime;
-    String location;
+// Upper bound on locations with a pre-rendered carousel frame (4.7 KB of PSRAM each)
+const int MAX_CAROUSEL_FRAMES = 16;
+
+// The rotation is the spots in the location catalog nearest to this position
+const float SURF_HOME_LATITUDE = 50.416f;   // Newquay
+const float SURF_HOME_LONGITUDE = -5.075f;
+const int SURF_ROTATION_SIZE = 7;
+
+// Last good data for one spot, saved to NVS after each fetch
+struct SpotSnapshot {
+    ForecastSummary summary;
+    float latitude;           // Spot the slot held, so a changed rotation is not mixed up
+    float longitude;
+    int64_t fetchedAt;        // Epoch seconds, 0 if the clock was not set
+    char fetchTime[48];       // Timestamp as shown on the panel
 };
 
 class SurfForecast : public SensorInterface {
 private:
     EPaperDisplay* display;
+    PanelGroup* panels = nullptr;  // With more than one panel, each spot gets its own
+    TelemetryPublisher* telemetry = nullptr;
+    RuleEngine* rules = nullptr;   // Alert rules fed with each spot's fresh conditions, keyed by rotation slot
     SurfConditions conditions;
     String lastFetchTime; // Store the UK time when data was last fetched
+    unsigned long lastSuccessfulFetch = 0; // millis() of the last successful fetch, 0 if none
+    bool lastFetchFailed = false;
     
     // API settings
-    const String API_URL = "https://marine-api.open-meteo.com/v1/marine";
+    String apiUrl = FORECAST_API_URL;
+    FetchPolicy fetchPolicy;
+    unsigned long lastUpdate = 0;
+    unsigned long nextUpdateDelay = REFRESH_INTERVAL_MS; // Shortened to the backoff delay while retrying
+    bool retryPending = false;                           // Next update refetches the same spot
     
-    static const SurfLocation* getSurfLocations();
-    static int getNumLocations();
+    // Spots come from the catalog in flash; the rotation holds the catalog
+    // indices of the active ones, and everything below is per rotation slot
+    LocationCatalog catalog;
+    uint32_t rotation[MAX_CAROUSEL_FRAMES];
+    int rotationCount = 0;
     int currentLocationIndex = 0;
     
+    SurfLocation getLocation(int slot) const;
+    int getNumLocations() const;
+    
+    // Carousel frames rendered right after a location's data changes (on the loop task, as part of
+    // the fetch), so showing a spot later is only a buffer push with nothing drawn on the display path
+    uint8_t* locationFrames[MAX_CAROUSEL_FRAMES] = {};
+    bool locationFrameReady[MAX_CAROUSEL_FRAMES] = {};
+    bool locationFrameShown[MAX_CAROUSEL_FRAMES] = {};  // Already on its own panel
+    unsigned long locationFetchTime[MAX_CAROUSEL_FRAMES] = {};
+    float referenceWaveHeight[MAX_CAROUSEL_FRAMES]; // Height the change threshold is measured from, NAN if none
+    AdaptiveInterval polling;
+    ForecastFormat format = FORECAST_FORMAT;
+    
+    // Every spot's hours are ranked as its data arrives; the series buffer
+    // receives the hourly points of the response being parsed
+    SessionRanker ranker;
+    float hourlyHeights[SESSION_MAX_HOURS];
+    bool compareFlatBuffers = false; // Format of the next fetch in COMPARE mode
+    
     // Helper methods
     String getRatingFromHeight(float heightMeters);
     float metersToFeet(float meters);
-    float calculateAverage(JsonArray& heights, int startHour, int endHour);
-    String getCurrentTimeString();
+    void ensureStaticLayer();
+    void applySummary(const ForecastSummary& summary, const String& fetchTime);
+    void saveSnapshot(int index, const ForecastSummary& summary);
+    void prerenderLocationFrame(int index);
+    void displayOnPanels();
+    bool parseResponse(HTTPClient& http, bool flatBuffers, ForecastSummary& summary, ForecastSeries& series,
+                       const char** error);
+    void rankSessions(int index, const ForecastSeries& series);
+    uint8_t* readBody(Stream& body, size_t& length, size_t& capacity);
+    bool attemptFetch();
+    bool isLocationFresh(int index, unsigned long now) const;
+    void recordPollingSample(int index);
     // Removed unused helper methods
     
 public:
     SurfForecast(EPaperDisplay* displayPtr);
-    virtual ~SurfForecast() {}
+    virtual ~SurfForecast();
 
     // Implement SensorInterface
     void begin(const char* ssid, const char* password) override;
     void update() override;
     void displayCurrentData() override;
     bool isDataReady() const override;
+    bool hasError() const override;
+    bool isDataStale() const override;
+    unsigned long getTimeUntilUpdate(unsigned long now) const override; // Next fetch or retry
+    bool restoreSnapshot() override;
+    void invalidateDisplay() override;
 
     // SurfForecast-specific methods
     bool fetchForecastData();
     void displayCurrentConditions(); // Legacy method for backward compatibility
     bool isWiFiConnected();
     void nextLocation();
+    void setTelemetry(TelemetryPublisher* publisher);
+    void setRuleEngine(RuleEngine* engine);
+    void setForecastFormat(ForecastFormat newFormat);
+    void setPanelGroup(PanelGroup* group);
+    void setApiUrl(const String& url);
+    
+    // Rotate through the count catalog spots nearest to a position (the
+    // catalog partition is mapped on first use); returns how many were found
+    int selectNearestSpots(float latitude, float longitude, int count);
+    // Rotate through these catalog indices; cached frames and rankings are dropped
+    bool setRotation(const uint32_t* indices, int count);
+    void printBestSessions();
 };
 
 #endif
@@ -0,0 +1,31 @@
+#ifndef SURF_LAYOUT_H
+#define SURF_LAYOUT_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+struct SurfConditions {
+    float currentWaveHeight;
+    float todayAverage;
+    float tomorrowAverage;
+    String currentRating;
+    String todayRating;
+    String tomorrowRating;
+    String currentTime;
+    String location;
+};
+
+// The surf forecast page (296x128 landscape): three columns for now, today
+// and tomorrow. Split into the constant chrome, rasterized once into the
+// display's static layer, and the values drawn on top of it every frame.
+// Depends only on Adafruit_GFX so the host tests can render it.
+class SurfLayout {
+public:
+    static void drawStatic(Adafruit_GFX* gfx);   // Rules and column labels
+    static void drawConditions(Adafruit_GFX* gfx, const SurfConditions& data);
+
+private:
+    static void drawForecastColumn(Adafruit_GFX* gfx, int center, float waveHeight, const String& rating);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+// Batching parameters - one UDP packet (one radio wake) carries a whole batch
+const int TELEMETRY_BATCH_SIZE = 8;                      // Samples per packet
+const int TELEMETRY_QUEUE_CAPACITY = 64;                 // Bounded store-and-forward queue
+const unsigned long TELEMETRY_MAX_BATCH_AGE_MS = 600000; // Flush partial batches after 10 minutes
+const int TELEMETRY_MAX_PACKETS_PER_LOOP = 2;            // Rate limit while draining a backlog
+const int TELEMETRY_MAX_FIELDS = 3;
+const int TELEMETRY_TAG_LENGTH = 24;
+const int TELEMETRY_PACKET_SIZE = 1024;                  // Stays below a single Ethernet MTU
+
+struct TelemetrySample {
+    uint32_t timestamp;                  // Unix epoch seconds, 0 if the clock is not synced
+    unsigned long queuedAt;              // millis() when queued, used for batch age
+    const char* measurement;             // Must point at a string literal
+    char tag[TELEMETRY_TAG_LENGTH];      // Optional "location" tag value
+    const char* fieldNames[TELEMETRY_MAX_FIELDS];
+    float fieldValues[TELEMETRY_MAX_FIELDS];
+    uint8_t fieldCount;
+};
+
+// Publishes sensor samples as InfluxDB line protocol over UDP.
+//
+// Samples are queued in a bounded ring buffer and sent in batches of
+// TELEMETRY_BATCH_SIZE lines per packet. Every line carries its own absolute
+// timestamp at second precision, 10 digits instead of the 19 of line
+// protocol's default nanoseconds, so the listener must be told the precision
+// (see TELEMETRY_HOST in main.cpp); samples taken before the clock synced
+// have none and get their arrival time. While WiFi is down samples stay queued
+// (oldest dropped when full) and are drained at a limited rate once the
+// connection returns.
+//
+// A local listener is enough to inspect the output: nc -ul 8094
+class TelemetryPublisher {
+private:
+    WiFiUDP udp;
+    String host;
+    uint16_t port;
+    String deviceId;
+    bool enabled;
+
+    TelemetrySample queue[TELEMETRY_QUEUE_CAPACITY];
+    int head;   // Index of the oldest queued sample
+    int count;
+
+    unsigned long packetsSent;
+    unsigned long samplesSent;
+    unsigned long samplesDropped;
+
+    void enqueue(const TelemetrySample& sample);
+    bool shouldFlush() const;
+    bool sendBatch();
+    int formatLine(char* buffer, size_t size, const TelemetrySample& sample);
+    static int escapeTag(char* buffer, size_t size, const char* value);
+
+public:
+    TelemetryPublisher();
+
+    // Empty host disables publishing; samples are then dropped immediately
+    void begin(const char* host, uint16_t port, const char* deviceId);
+    void loop(); // Call once per main loop iteration
+
+    void record(const char* measurement, const char* tag,
+                const char* name1, float value1,
+                const char* name2 = nullptr, float value2 = 0.0f,
+                const char* name3 = nullptr, float value3 = 0.0f);
+
+    int getQueuedCount() const;
+    void printStats() const;
+};
+
+#endif
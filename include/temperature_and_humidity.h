@@ -5,24 +5,36 @@
 #include <DHT.h>
 #include "epaper_display.h"
 #include "sensor_interface.h"
+#include "telemetry_publisher.h"
+#include "adaptive_interval.h"
+#include "rule_engine.h"
+#include "climate_layout.h"
 
-struct TempHumidityData {
+// Last good reading, saved to NVS after each valid sample
+struct TempHumiditySnapshot {
     float temperature;
     float humidity;
-    String lastUpdateTime;
-    bool sensorError;
+    char lastUpdateTime[48];  // Timestamp as shown on the panel
 };
 
 class TemperatureHumiditySensor : public SensorInterface {
 private:
     EPaperDisplay* display;
-    DHT* dhtSensor;
+    TelemetryPublisher* telemetry;
+    RuleEngine* rules;      // Alert rules fed with every valid reading
+    DHT dhtSensor;
     TempHumidityData currentData;
 
     int dhtPin;
     uint8_t dhtType;
     unsigned long lastUpdateTime;
-    const unsigned long UPDATE_INTERVAL_MS = 30000; // 30 seconds
+    const unsigned long UPDATE_INTERVAL_MS = 30000;      // 30 seconds - fastest sampling, and the old fixed rate
+    const unsigned long UPDATE_INTERVAL_MAX_MS = 600000; // 10 minutes - slowest sampling while readings are flat
+    const float TEMPERATURE_CHANGE_C = 0.5f;             // Movement that snaps sampling back to the fastest rate
+    const float HUMIDITY_CHANGE_PERCENT = 2.0f;
+    AdaptiveInterval sampling;
+    float referenceTemperature; // Reading the change thresholds are measured from, NAN if none
+    float referenceHumidity;
     bool initialized;
 
     void readSensor();
@@ -39,10 +51,15 @@ public:
     void update() override;
     void displayCurrentData() override;
     bool isDataReady() const override;
+    bool hasError() const override;
+    unsigned long getTimeUntilUpdate(unsigned long now) const override; // Next sample
+    bool restoreSnapshot() override;
 
     // Sensor-specific methods
     TempHumidityData getCurrentData() const;
     bool isSensorWorking() const;
+    void setTelemetry(TelemetryPublisher* publisher);
+    void setRuleEngine(RuleEngine* engine);
 };
 
 #endif
@@ -0,0 +1,42 @@
+#ifndef TEXT_METRICS_H
+#define TEXT_METRICS_H
+
+#include <stddef.h>
+
+// Metrics for the built-in Adafruit GFX font (5x7 glyphs in a 6x8 cell).
+// Every character advances 6 * textSize pixels, so for single-line text that
+// fits the display getTextBounds() always reports length * 6 * textSize.
+// All helpers are constexpr: with literal strings the results are resolved at
+// compile time and no display state is touched.
+class TextMetrics {
+public:
+    static constexpr int GLYPH_ADVANCE = 6;
+    static constexpr int GLYPH_HEIGHT = 8;
+
+    static constexpr size_t length(const char* text) {
+        return *text ? 1 + length(text + 1) : 0;
+    }
+
+    static constexpr int width(size_t length, int textSize) {
+        return (int)length * GLYPH_ADVANCE * textSize;
+    }
+
+    static constexpr int textWidth(const char* text, int textSize = 1) {
+        return width(length(text), textSize);
+    }
+
+    static constexpr int height(int textSize = 1) {
+        return GLYPH_HEIGHT * textSize;
+    }
+
+    // Cursor x that centres text of the given pixel width on a column centerline
+    static constexpr int centeredX(int center, int textWidth) {
+        return center - textWidth / 2;
+    }
+
+    static constexpr int centeredX(int center, const char* text, int textSize) {
+        return centeredX(center, textWidth(text, textSize));
+    }
+};
+
+#endif
@@ -4,23 +4,43 @@
 #include <Arduino.h>
 #include <time.h>
 
+// Where the current wall-clock time came from, in increasing order of accuracy
+enum class TimeSource : uint8_t {
+    NONE,      // Clock not set - timestamps fall back to uptime
+    RTC,       // Epoch retained in RTC memory across a reset
+    HTTP_DATE, // Date header of an HTTP response (1 s resolution)
+    SNTP       // Synchronized with an NTP server
+};
+
 class TimeUtils {
 public:
-    // Initialize NTP time sync
+    // Seed the clock from RTC memory and start background SNTP sync.
+    // Safe to call more than once; never blocks waiting for the network.
     static void begin();
 
+    // Seed the clock from an HTTP "Date" header (RFC 7231 IMF-fixdate) unless
+    // a better source has already set it. Returns true if the clock was set.
+    static bool seedFromHttpDate(const String& date);
+
     // Get current timestamp with full date formatting
     static String getCurrentTimestamp();
 
     // Get ordinal suffix for day of month (1st, 2nd, 3rd, etc.)
     static String getOrdinalSuffix(int day);
 
-    // Check if NTP time is synchronized
+    // Check if the wall clock has been set (from any source)
     static bool isTimeSynced();
+    static TimeSource getTimeSource();
+    static const char* getTimeSourceName();
 
 private:
     // Helper method for fallback timestamp
     static String getFallbackTimestamp();
+
+    static void setClock(time_t epoch, TimeSource source);
+    static void recordReference(int64_t epochUs);
+    static void onSntpSync(struct timeval* tv);
+    static time_t parseHttpDate(const char* date);
 };
 
 #endif
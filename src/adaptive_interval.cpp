@@ -0,0 +1,60 @@
+#include <Arduino.h>
+#include "../include/adaptive_interval.h"
+
+AdaptiveInterval::AdaptiveInterval(const char* intervalName, unsigned long fixedMs,
+                                   unsigned long minMs, unsigned long maxMs)
+    : name(intervalName), fixedIntervalMs(fixedMs), minIntervalMs(minMs), maxIntervalMs(maxMs),
+      intervalMs(minMs), startTime(0), samples(0), stableStreak(0) {
+}
+
+unsigned long AdaptiveInterval::getInterval() const {
+    return intervalMs;
+}
+
+void AdaptiveInterval::recordSample(bool changed) {
+    if (samples == 0) startTime = millis();
+    samples++;
+
+    if (changed) {
+        stableStreak = 0;
+        intervalMs = minIntervalMs;
+        logDecision("changed");
+        return;
+    }
+
+    stableStreak++;
+    unsigned long stretched = (unsigned long)(intervalMs * ADAPTIVE_INTERVAL_GROWTH);
+    intervalMs = stretched > maxIntervalMs ? maxIntervalMs : stretched;
+    logDecision("stable");
+}
+
+void AdaptiveInterval::recordFailure() {
+    if (samples == 0) startTime = millis();
+    samples++;
+    stableStreak = 0;
+    intervalMs = minIntervalMs;
+    logDecision("failed");
+}
+
+unsigned long AdaptiveInterval::getSampleCount() const {
+    return samples;
+}
+
+unsigned long AdaptiveInterval::getFixedScheduleCount() const {
+    if (samples == 0) return 0;
+    return (millis() - startTime) / fixedIntervalMs + 1; // +1 for the first sample
+}
+
+long AdaptiveInterval::getSavedCount() const {
+    return (long)getFixedScheduleCount() - (long)samples;
+}
+
+bool AdaptiveInterval::exceeds(float previous, float current, float threshold) {
+    return isnan(previous) || fabsf(current - previous) >= threshold;
+}
+
+void AdaptiveInterval::logDecision(const char* reason) {
+    Serial.printf("%s: %s (%d stable in a row) -> next in %lu s | %lu samples vs %lu fixed, saved %ld\n",
+                  name, reason, stableStreak, intervalMs / 1000,
+                  samples, getFixedScheduleCount(), getSavedCount());
+}
@@ -0,0 +1,77 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include "../include/boot_snapshot.h"
+
+static const uint32_t FNV_OFFSET_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+bool BootSnapshot::save(const char* key, const void* data, size_t size) {
+    uint8_t blob[BOOT_SNAPSHOT_MAX_BYTES];
+    size_t length = sizeof(BOOT_SNAPSHOT_FORMAT) + size;
+    if (length > sizeof(blob)) {
+        Serial.printf("Snapshot '%s' is too large (%u bytes)\n", key, (unsigned)size);
+        return false;
+    }
+    memcpy(blob, &BOOT_SNAPSHOT_FORMAT, sizeof(BOOT_SNAPSHOT_FORMAT));
+    memcpy(blob + sizeof(BOOT_SNAPSHOT_FORMAT), data, size);
+
+    Preferences prefs;
+    if (!prefs.begin(BOOT_SNAPSHOT_NAMESPACE, false)) {
+        Serial.println("NVS unavailable, snapshot not saved");
+        return false;
+    }
+
+    // Unchanged data is common (same reading, same frame); don't wear the flash for it
+    uint8_t stored[BOOT_SNAPSHOT_MAX_BYTES];
+    bool unchanged = prefs.getBytesLength(key) == length &&
+                     prefs.getBytes(key, stored, length) == length &&
+                     memcmp(stored, blob, length) == 0;
+    bool saved = unchanged || prefs.putBytes(key, blob, length) == length;
+    prefs.end();
+
+    if (!saved) {
+        Serial.printf("Failed to save snapshot '%s'\n", key);
+    }
+    return saved;
+}
+
+bool BootSnapshot::load(const char* key, void* data, size_t size) {
+    uint8_t blob[BOOT_SNAPSHOT_MAX_BYTES];
+    size_t length = sizeof(BOOT_SNAPSHOT_FORMAT) + size;
+    if (length > sizeof(blob)) return false;
+
+    Preferences prefs;
+    if (!prefs.begin(BOOT_SNAPSHOT_NAMESPACE, true)) return false;
+    bool found = prefs.getBytesLength(key) == length && prefs.getBytes(key, blob, length) == length;
+    prefs.end();
+
+    uint32_t format = 0;
+    if (found) memcpy(&format, blob, sizeof(format));
+    if (!found || format != BOOT_SNAPSHOT_FORMAT) return false;
+
+    memcpy(data, blob + sizeof(BOOT_SNAPSHOT_FORMAT), size);
+    return true;
+}
+
+uint32_t BootSnapshot::loadPanelFingerprint(int csPin) {
+    char key[16];
+    snprintf(key, sizeof(key), "panel_cs%d", csPin);
+    uint32_t fingerprint = 0;
+    return load(key, &fingerprint, sizeof(fingerprint)) ? fingerprint : 0;
+}
+
+void BootSnapshot::savePanelFingerprint(int csPin, uint32_t fingerprint) {
+    char key[16];
+    snprintf(key, sizeof(key), "panel_cs%d", csPin);
+    save(key, &fingerprint, sizeof(fingerprint));
+}
+
+uint32_t BootSnapshot::fingerprint(const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash ? hash : 1;
+}
@@ -0,0 +1,75 @@
+#include <Arduino.h>
+#include <GxEPD2_BW.h>
+#include "../include/climate_layout.h"
+#include "../include/text_metrics.h"
+
+// Column centerlines for 2-column layout (296px width)
+// Each column is 148px wide, centered at 74 and 222
+static constexpr int COL1_CENTER = 74;   // Column 1 centerline (TEMPERATURE) - 296/4
+static constexpr int COL2_CENTER = 222;  // Column 2 centerline (HUMIDITY) - 296*3/4
+static constexpr int COL_Y = 40;         // Start Y position for column content
+
+// Label positions resolved at compile time from the built-in font metrics
+static constexpr int TEMPERATURE_LABEL_X = TextMetrics::centeredX(COL1_CENTER, "TEMPERATURE", 1);
+static constexpr int HUMIDITY_LABEL_X = TextMetrics::centeredX(COL2_CENTER, "HUMIDITY", 1);
+
+void ClimateLayout::drawStatic(Adafruit_GFX* gfx) {
+    // Header - "How moist is our home?"
+    gfx->setTextSize(1.5);
+    gfx->setCursor(2, 6);
+    gfx->print("How moist is our home?");
+
+    // Draw horizontal line under header
+    gfx->drawLine(2, 20, 294, 20, GxEPD_BLACK);
+
+    // Draw vertical separator between columns at center of display
+    gfx->drawLine(148, 20, 148, 108, GxEPD_BLACK); // Center line at 296/2
+
+    // Column 1 - TEMPERATURE
+    gfx->setTextSize(1);
+    gfx->setCursor(TEMPERATURE_LABEL_X, COL_Y);
+    gfx->print("TEMPERATURE");
+
+    // Column 2 - HUMIDITY
+    gfx->setCursor(HUMIDITY_LABEL_X, COL_Y);
+    gfx->print("HUMIDITY");
+
+    // Draw horizontal line above footer
+    gfx->drawLine(2, 108, 294, 108, GxEPD_BLACK);
+}
+
+void ClimateLayout::drawReadings(Adafruit_GFX* gfx, const TempHumidityData& data) {
+    // Temperature value
+    char tempStr[20];
+    sprintf(tempStr, "%.1f", data.temperature);
+    int tempValueWidth = TextMetrics::width(strlen(tempStr), 3);
+    gfx->setTextSize(3);
+    gfx->setCursor(TextMetrics::centeredX(COL1_CENTER, tempValueWidth), COL_Y + 15);
+    gfx->print(tempStr);
+
+    // Temperature unit
+    gfx->setTextSize(1);
+    gfx->setCursor(COL1_CENTER + tempValueWidth/2 + 2, COL_Y + 15);
+    gfx->print("C");
+
+    // Humidity value
+    char humStr[20];
+    sprintf(humStr, "%.1f", data.humidity);
+    int humValueWidth = TextMetrics::width(strlen(humStr), 3);
+    gfx->setTextSize(3);
+    gfx->setCursor(TextMetrics::centeredX(COL2_CENTER, humValueWidth), COL_Y + 15);
+    gfx->print(humStr);
+
+    // Humidity unit
+    gfx->setTextSize(1);
+    gfx->setCursor(COL2_CENTER + humValueWidth/2 + 2, COL_Y + 15);
+    gfx->print("%");
+
+    // Footer - show last updated time (same format as surf forecast)
+    String timeStr = data.lastUpdateTime.isEmpty() ? "??:??:?? Unknown Date" :
+                   (data.lastUpdateTime.endsWith("s ago") ? data.lastUpdateTime : data.lastUpdateTime);
+    String updateText = "Last updated: " + timeStr;
+    gfx->setTextSize(1.5);
+    gfx->setCursor(2, 114);
+    gfx->print(updateText);
+}
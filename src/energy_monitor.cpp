@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "../include/energy_monitor.h"
+
+static const int STATE_COUNT = (int)PowerState::COUNT;
+static const float US_PER_HOUR = 3600.0f * 1000000.0f;
+
+static portMUX_TYPE energyMux = portMUX_INITIALIZER_UNLOCKED;
+static PowerModel powerModel;
+static int64_t startTimeUs = 0;
+static int64_t lastUpdateUs = 0;
+static int activeCount[STATE_COUNT] = {};
+static int64_t stateTimeUs[STATE_COUNT] = {};
+
+void EnergyMonitor::begin() {
+    portENTER_CRITICAL(&energyMux);
+    startTimeUs = esp_timer_get_time();
+    lastUpdateUs = startTimeUs;
+    for (int i = 0; i < STATE_COUNT; i++) {
+        activeCount[i] = 0;
+        stateTimeUs[i] = 0;
+    }
+    portEXIT_CRITICAL(&energyMux);
+    Serial.println("Energy accounting started");
+}
+
+void EnergyMonitor::setPowerModel(const PowerModel& model) {
+    portENTER_CRITICAL(&energyMux);
+    powerModel = model;
+    portEXIT_CRITICAL(&energyMux);
+}
+
+// Each panel in a PanelGroup draws its own refresh current, so overlapping
+// refreshes add up; other states count once however deeply they nest
+static bool isPerInstance(int state) {
+    return state == (int)PowerState::PANEL_FULL_REFRESH;
+}
+
+void EnergyMonitor::accumulate(int64_t now) {
+    // Caller holds energyMux
+    int64_t elapsed = now - lastUpdateUs;
+    for (int i = 0; i < STATE_COUNT; i++) {
+        if (activeCount[i] > 0) stateTimeUs[i] += isPerInstance(i) ? elapsed * activeCount[i] : elapsed;
+    }
+    lastUpdateUs = now;
+}
+
+void EnergyMonitor::enter(PowerState state) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&energyMux);
+    accumulate(now);
+    activeCount[(int)state]++;
+    portEXIT_CRITICAL(&energyMux);
+}
+
+void EnergyMonitor::exit(PowerState state) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&energyMux);
+    accumulate(now);
+    if (activeCount[(int)state] > 0) activeCount[(int)state]--;
+    portEXIT_CRITICAL(&energyMux);
+}
+
+void EnergyMonitor::setActive(PowerState state, bool active) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&energyMux);
+    accumulate(now);
+    activeCount[(int)state] = active ? 1 : 0;
+    portEXIT_CRITICAL(&energyMux);
+}
+
+float EnergyMonitor::stateCurrentMa(PowerState state) {
+    switch (state) {
+        case PowerState::CPU_ACTIVE: return powerModel.cpuActiveMa;
+        case PowerState::RADIO_ASSOCIATED: return powerModel.radioAssociatedMa;
+        case PowerState::RADIO_TRANSMITTING: return powerModel.radioTransmittingMa;
+        case PowerState::PANEL_FULL_REFRESH: return powerModel.panelFullRefreshMa;
+        case PowerState::DHT_ACQUISITION: return powerModel.dhtAcquisitionMa;
+        default: return 0.0f;
+    }
+}
+
+const char* EnergyMonitor::stateName(PowerState state) {
+    switch (state) {
+        case PowerState::CPU_ACTIVE: return "CPU active";
+        case PowerState::RADIO_ASSOCIATED: return "Radio associated";
+        case PowerState::RADIO_TRANSMITTING: return "Radio transmitting";
+        case PowerState::PANEL_FULL_REFRESH: return "Panel full refresh";
+        case PowerState::DHT_ACQUISITION: return "DHT acquisition";
+        default: return "?";
+    }
+}
+
+float EnergyMonitor::getConsumedMah() {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&energyMux);
+    accumulate(now);
+    int64_t elapsed = now - startTimeUs;
+    int64_t cpuUs = stateTimeUs[(int)PowerState::CPU_ACTIVE];
+
+    // CPU active and idle split the timeline; the other states add on top
+    float chargeMaUs = (float)(elapsed - cpuUs) * powerModel.idleMa + (float)cpuUs * powerModel.cpuActiveMa;
+    for (int i = 0; i < STATE_COUNT; i++) {
+        if (i == (int)PowerState::CPU_ACTIVE) continue;
+        chargeMaUs += (float)stateTimeUs[i] * stateCurrentMa((PowerState)i);
+    }
+    portEXIT_CRITICAL(&energyMux);
+
+    return chargeMaUs / US_PER_HOUR;
+}
+
+float EnergyMonitor::getAverageMa() {
+    float elapsedHours = (float)(esp_timer_get_time() - startTimeUs) / US_PER_HOUR;
+    return elapsedHours > 0 ? getConsumedMah() / elapsedHours : 0.0f;
+}
+
+float EnergyMonitor::getProjectedMahPerDay() {
+    return getAverageMa() * 24.0f;
+}
+
+void EnergyMonitor::printReport() {
+    // Snapshot under the lock, print outside it
+    int64_t now = esp_timer_get_time();
+    int64_t times[STATE_COUNT];
+    portENTER_CRITICAL(&energyMux);
+    accumulate(now);
+    int64_t elapsed = now - startTimeUs;
+    for (int i = 0; i < STATE_COUNT; i++) times[i] = stateTimeUs[i];
+    portEXIT_CRITICAL(&energyMux);
+
+    float elapsedS = elapsed / 1000000.0f;
+    int64_t idleUs = elapsed - times[(int)PowerState::CPU_ACTIVE];
+
+    Serial.printf("Energy report after %.0f s:\n", elapsedS);
+    Serial.printf("  %-22s %9.1f s %8.3f mAh\n", "Idle",
+                  idleUs / 1000000.0f, idleUs * powerModel.idleMa / US_PER_HOUR);
+    for (int i = 0; i < STATE_COUNT; i++) {
+        Serial.printf("  %-22s %9.1f s %8.3f mAh\n", stateName((PowerState)i),
+                      times[i] / 1000000.0f, times[i] * stateCurrentMa((PowerState)i) / US_PER_HOUR);
+    }
+
+    float consumed = getConsumedMah();
+    float averageMa = elapsedS > 0 ? consumed / (elapsedS / 3600.0f) : 0.0f;
+    Serial.printf("  Total: %.3f mAh, average %.1f mA, projected %.0f mAh/day\n",
+                  consumed, averageMa, averageMa * 24.0f);
+}
+
+void EnergyMonitor::publish(TelemetryPublisher& telemetry) {
+    telemetry.record("energy", nullptr,
+                     "consumed_mah", getConsumedMah(),
+                     "average_ma", getAverageMa(),
+                     "projected_mah_day", getProjectedMahPerDay());
+}
@@ -1,21 +1,66 @@
 #include <Arduino.h>
+#include <new>
 #include "../include/epaper_display.h"
+#include "../include/energy_monitor.h"
+#include "../include/memory_report.h"
+#include "../include/boot_snapshot.h"
+
+static const EventBits_t REFRESH_IDLE_BIT = BIT0;
 
 EPaperDisplay::EPaperDisplay(int cs, int dc, int rst, int busy) 
-    : csPin(cs), dcPin(dc), rstPin(rst), busyPin(busy) {
-    display = new GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT>(GxEPD2_290_BS(cs, dc, rst, busy));
+    : csPin(cs), dcPin(dc), rstPin(rst), busyPin(busy), frame(frameStorage), shownFingerprint(0),
+      staticLayer(nullptr), staticLayerValid(false),
+      asyncRefresh(false), refreshTask(nullptr), busySignal(nullptr), refreshEvents(nullptr) {
+    // The driver object embeds GxEPD2's own page buffer; keep it in internal RAM next to the SPI path,
+    // or anywhere on the heap if internal RAM is short. Serial is not up yet, so begin() reports it.
+    void* driverStorage = MemoryReport::allocate("display", "GxEPD2 driver", sizeof(EpdDriver), MemoryPlacement::INTERNAL);
+    driverInternal = driverStorage != nullptr;
+    if (driverInternal) {
+        display = new (driverStorage) EpdDriver(GxEPD2_290_BS(cs, dc, rst, busy));
+    } else {
+        display = new (std::nothrow) EpdDriver(GxEPD2_290_BS(cs, dc, rst, busy));
+    }
+    MemoryReport::registerBuffer("display", "frame", frameStorage, FrameBuffer::BUFFER_SIZE, MemoryPlacement::STATIC);
+    frame.fillScreen(GxEPD_WHITE);
+    frame.setRotation(1); // Landscape orientation
 }
 
 EPaperDisplay::~EPaperDisplay() {
-    delete display;
+    if (driverInternal) {
+        display->~EpdDriver();
+        MemoryReport::release(display);
+    } else {
+        delete display;
+    }
+    MemoryReport::release(staticLayer);
 }
 
 void EPaperDisplay::begin() {
     Serial.println("Initializing e-paper display with CORRECTED driver...");
+    if (!display) {
+        // Every other method goes through the driver, so there is nothing useful left to run
+        Serial.printf("FATAL: no memory for the e-paper driver (%u bytes) - halted\n", (unsigned)sizeof(EpdDriver));
+        while (true) delay(1000);
+    }
+    if (!driverInternal) {
+        Serial.printf("Internal RAM short: e-paper driver (%u bytes) allocated from the general heap\n",
+                      (unsigned)sizeof(EpdDriver));
+    }
     
     display->init(115200); // Enable diagnostic output
     Serial.println("Display init completed");
     
+    // BUSY goes low when the panel finishes a waveform. Let the ISR wake the
+    // waiting task instead of GxEPD2 polling the pin in a tight loop.
+    busySignal = xSemaphoreCreateBinary();
+    refreshEvents = xEventGroupCreate();
+    xEventGroupSetBits(refreshEvents, REFRESH_IDLE_BIT);
+    attachInterruptArg(busyPin, onBusyEdge, this, FALLING);
+    display->epd2.setBusyCallback(waitForBusyEdge, this);
+    
+    shownFingerprint = BootSnapshot::loadPanelFingerprint(csPin);
+    Serial.printf("Panel fingerprint at boot: %08lx\n", (unsigned long)shownFingerprint);
+    
     printPinAssignments();
 }
 
@@ -31,6 +76,9 @@ void EPaperDisplay::printPinAssignments() {
 }
 
 void EPaperDisplay::clear() {
+    waitForRefresh();
+    forgetShownFrame();
+    EnergyScope refresh(PowerState::PANEL_FULL_REFRESH);
     display->setFullWindow();
     display->firstPage();
     do {
@@ -40,6 +88,9 @@ void EPaperDisplay::clear() {
 }
 
 void EPaperDisplay::fillScreen(uint16_t color) {
+    waitForRefresh();
+    forgetShownFrame();
+    EnergyScope refresh(PowerState::PANEL_FULL_REFRESH);
     display->setFullWindow();
     display->firstPage();
     do {
@@ -49,6 +100,9 @@ void EPaperDisplay::fillScreen(uint16_t color) {
 }
 
 void EPaperDisplay::showText(const char* text, int x, int y, int textSize) {
+    waitForRefresh();
+    forgetShownFrame();
+    EnergyScope refresh(PowerState::PANEL_FULL_REFRESH);
     display->setRotation(1); // Landscape orientation
     display->setFullWindow();
     display->firstPage();
@@ -67,6 +121,9 @@ void EPaperDisplay::showText(const char* text, int x, int y, int textSize) {
 
 void EPaperDisplay::showHelloWorld() {
     Serial.println("Displaying HELLO WORLD on e-paper...");
+    waitForRefresh();
+    forgetShownFrame();
+    EnergyScope refresh(PowerState::PANEL_FULL_REFRESH);
     
     display->setRotation(1); // Landscape orientation
     display->setFullWindow();
@@ -102,6 +159,7 @@ void EPaperDisplay::testDisplay() {
 }
 
 void EPaperDisplay::sleep() {
+    waitForRefresh();
     display->hibernate(); // Put display in low power mode
     Serial.println("Display put to sleep");
 }
@@ -112,6 +170,8 @@ void EPaperDisplay::sleep() {
 // and manage your own do...while(nextPage()) loop.
 
 void EPaperDisplay::startUpdate() {
+    waitForRefresh();
+    forgetShownFrame();
     display->setRotation(1); // Landscape orientation
     display->setFullWindow();
     display->firstPage();
@@ -141,16 +201,186 @@ void EPaperDisplay::finishUpdate() {
 }
 
 int EPaperDisplay::getTextWidth(const char* text, int textSize) {
-    display->setFont(); // Use default font
+    // Fixed-width built-in font: width is a pure function of length and size
+    return TextMetrics::width(strlen(text), textSize);
+}
+
+int EPaperDisplay::getTextWidth(const char* text, const GFXfont* font, int textSize) {
+    if (!font) return getTextWidth(text, textSize);
+    
+    // Measure on the GxEPD2 object so the frame's font and text size are untouched
+    display->setRotation(1); // Landscape orientation
+    display->setFont(font);
     display->setTextSize(textSize);
     
     int16_t x1, y1;
     uint16_t w, h;
     display->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
     
+    display->setFont();
     return w;
 }
 
 GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT>* EPaperDisplay::getDisplay() {
     return display;
 }
+
+Adafruit_GFX* EPaperDisplay::beginFrame(bool useStaticLayer) {
+    prepareFrame(useStaticLayer);
+    return &frame;
+}
+
+void EPaperDisplay::prepareFrame(bool useStaticLayer) {
+    // The frame buffer is being streamed to the panel until the refresh ends
+    waitForRefresh();
+    prepareCanvas(frame, useStaticLayer);
+}
+
+void EPaperDisplay::prepareCanvas(FrameBuffer& canvas, bool useStaticLayer) {
+    canvas.beginPage(useStaticLayer && staticLayerValid ? staticLayer : nullptr);
+}
+
+void EPaperDisplay::showFrame(const uint8_t* image) {
+    waitForRefresh();
+    frame.copyFrom(image);
+    endFrame();
+}
+
+Adafruit_GFX* EPaperDisplay::beginStaticLayer() {
+    prepareFrame(false);
+    return &frame;
+}
+
+void EPaperDisplay::endStaticLayer() {
+    if (!staticLayer) {
+        // Only ever memcpy'd into the frame, so it can live in PSRAM
+        staticLayer = (uint8_t*)MemoryReport::allocate("display", "static layer", FrameBuffer::BUFFER_SIZE,
+                                                       MemoryPlacement::PSRAM);
+        if (!staticLayer) {
+            Serial.println("Not enough memory for the static layer, drawing it every frame");
+            return;
+        }
+    }
+    frame.copyTo(staticLayer);
+    staticLayerValid = true;
+    Serial.printf("Static layer rasterized (%u bytes)\n", (unsigned)FrameBuffer::BUFFER_SIZE);
+}
+
+bool EPaperDisplay::hasStaticLayer() const {
+    return staticLayerValid;
+}
+
+void EPaperDisplay::invalidateStaticLayer() {
+    staticLayerValid = false;
+}
+
+void EPaperDisplay::endFrame() {
+    // E-paper keeps its image, so a frame identical to the one showing needs no refresh
+    uint32_t fingerprint = BootSnapshot::fingerprint(frame.getBuffer(), FrameBuffer::BUFFER_SIZE);
+    if (fingerprint == shownFingerprint) {
+        Serial.printf("Frame unchanged on CS %d - refresh skipped\n", csPin);
+        return;
+    }
+    shownFingerprint = fingerprint;
+    
+    if (asyncRefresh && refreshTask) {
+        xEventGroupClearBits(refreshEvents, REFRESH_IDLE_BIT);
+        xTaskNotifyGive(refreshTask);
+        return;
+    }
+    pushFrame();
+}
+
+void EPaperDisplay::pushFrame() {
+    // Same sequence as GxEPD2_BW::display() for a full refresh, fed from our frame
+    // The SPI transfers and the NVS write keep the CPU busy (on the refresh task when
+    // async); the waveform in between is a wait on BUSY and only counts as panel time
+    EnergyScope refresh(PowerState::PANEL_FULL_REFRESH);
+    const uint8_t* image = frame.getBuffer();
+    {
+        EnergyScope transfer(PowerState::CPU_ACTIVE);
+        display->epd2.writeImage(image, 0, 0, FrameBuffer::NATIVE_WIDTH, FrameBuffer::NATIVE_HEIGHT);
+    }
+    display->epd2.refresh(false);
+    {
+        EnergyScope transfer(PowerState::CPU_ACTIVE);
+        display->epd2.writeImageAgain(image, 0, 0, FrameBuffer::NATIVE_WIDTH, FrameBuffer::NATIVE_HEIGHT);
+        display->hibernate();
+        BootSnapshot::savePanelFingerprint(csPin, shownFingerprint);
+    }
+}
+
+void EPaperDisplay::forgetShownFrame() {
+    if (shownFingerprint == 0) return;
+    shownFingerprint = 0;
+    BootSnapshot::savePanelFingerprint(csPin, 0);
+}
+
+void EPaperDisplay::setAsyncRefresh(bool enabled) {
+    if (enabled && !refreshTask) {
+        if (!refreshEvents) {
+            Serial.println("Async refresh requires begin() first");
+            return;
+        }
+        // Core 0 alongside WiFi; the task sleeps for almost the whole refresh.
+        // One task per panel, so panels sharing the SPI bus refresh in parallel.
+        char taskName[configMAX_TASK_NAME_LEN];
+        snprintf(taskName, sizeof(taskName), "epd_cs%d", csPin);
+        xTaskCreatePinnedToCore(refreshTaskEntry, taskName, 4096, this, 1, &refreshTask, 0);
+        MemoryReport::registerTask(refreshTask);
+    }
+    waitForRefresh();
+    asyncRefresh = enabled;
+    Serial.printf("E-paper async refresh %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool EPaperDisplay::isRefreshing() const {
+    return refreshEvents && !(xEventGroupGetBits(refreshEvents) & REFRESH_IDLE_BIT);
+}
+
+bool EPaperDisplay::waitForRefresh(unsigned long timeoutMs) {
+    if (!refreshEvents) return true;
+    EventBits_t bits = xEventGroupWaitBits(refreshEvents, REFRESH_IDLE_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    if (!(bits & REFRESH_IDLE_BIT)) {
+        Serial.println("Timed out waiting for e-paper refresh");
+        return false;
+    }
+    return true;
+}
+
+uint32_t EPaperDisplay::getShownFingerprint() const {
+    return shownFingerprint;
+}
+
+void IRAM_ATTR EPaperDisplay::onBusyEdge(void* arg) {
+    EPaperDisplay* self = static_cast<EPaperDisplay*>(arg);
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(self->busySignal, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void EPaperDisplay::waitForBusyEdge(const void* arg) {
+    // Called by GxEPD2 while BUSY is active. Block until the edge interrupt
+    // fires; the short timeout lets GxEPD2 re-check the pin and its own timeout.
+    const EPaperDisplay* self = static_cast<const EPaperDisplay*>(arg);
+    xSemaphoreTake(self->busySignal, pdMS_TO_TICKS(50));
+}
+
+void EPaperDisplay::refreshTaskEntry(void* arg) {
+    static_cast<EPaperDisplay*>(arg)->refreshLoop();
+}
+
+void EPaperDisplay::refreshLoop() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        unsigned long start = millis();
+        pushFrame();
+        Serial.printf("Async e-paper refresh (CS %d) completed in %lu ms\n", csPin, millis() - start);
+        
+        xEventGroupSetBits(refreshEvents, REFRESH_IDLE_BIT);
+    }
+}
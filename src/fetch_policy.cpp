@@ -0,0 +1,106 @@
+#include <Arduino.h>
+#include "../include/fetch_policy.h"
+
+FetchPolicy::FetchPolicy(const char* policyName)
+    : name(policyName), state(CircuitState::CLOSED), consecutiveFailures(0), openedAt(0),
+      cooldownMs(FETCH_BREAKER_COOLDOWN_MS), retryDelayMs(0), attempts(0), failures(0), suppressed(0) {
+}
+
+bool FetchPolicy::allowRequest(unsigned long now) {
+    if (state == CircuitState::OPEN) {
+        if (now - openedAt < cooldownMs) {
+            suppressed++;
+            return false;
+        }
+        state = CircuitState::HALF_OPEN;
+        retryDelayMs = 0;
+        logDecision("cooldown over, probing");
+    }
+
+    attempts++;
+    return true;
+}
+
+void FetchPolicy::recordSuccess() {
+    bool recovered = state != CircuitState::CLOSED || consecutiveFailures > 0;
+    state = CircuitState::CLOSED;
+    consecutiveFailures = 0;
+    cooldownMs = FETCH_BREAKER_COOLDOWN_MS;
+    retryDelayMs = 0;
+    if (recovered) logDecision("recovered");
+}
+
+void FetchPolicy::recordFailure(unsigned long now) {
+    failures++;
+    consecutiveFailures++;
+
+    if (state == CircuitState::HALF_OPEN) {
+        unsigned long doubled = cooldownMs * 2;
+        cooldownMs = doubled > FETCH_BREAKER_MAX_COOLDOWN_MS ? FETCH_BREAKER_MAX_COOLDOWN_MS : doubled;
+        open(now);
+        return;
+    }
+    if (consecutiveFailures >= FETCH_BREAKER_THRESHOLD) {
+        open(now);
+        return;
+    }
+
+    // Half fixed, half random: never retries immediately, never in lockstep
+    int exponent = consecutiveFailures - 1 < 16 ? consecutiveFailures - 1 : 16;
+    unsigned long ceiling = FETCH_BACKOFF_BASE_MS << exponent;
+    if (ceiling > FETCH_BACKOFF_MAX_MS) ceiling = FETCH_BACKOFF_MAX_MS;
+    retryDelayMs = ceiling / 2 + esp_random() % (ceiling / 2 + 1);
+    logDecision("failed");
+}
+
+void FetchPolicy::open(unsigned long now) {
+    state = CircuitState::OPEN;
+    openedAt = now;
+    retryDelayMs = cooldownMs;
+    logDecision("circuit opened");
+}
+
+CircuitState FetchPolicy::getState() const {
+    return state;
+}
+
+const char* FetchPolicy::getStateName() const {
+    switch (state) {
+        case CircuitState::CLOSED: return "closed";
+        case CircuitState::OPEN: return "open";
+        case CircuitState::HALF_OPEN: return "half-open";
+    }
+    return "unknown";
+}
+
+int FetchPolicy::getConsecutiveFailures() const {
+    return consecutiveFailures;
+}
+
+unsigned long FetchPolicy::getRetryDelay() const {
+    return retryDelayMs;
+}
+
+unsigned long FetchPolicy::getTimeUntilProbe(unsigned long now) const {
+    if (state != CircuitState::OPEN) return 0;
+    unsigned long elapsed = now - openedAt;
+    return elapsed < cooldownMs ? cooldownMs - elapsed : 0;
+}
+
+unsigned long FetchPolicy::getAttemptCount() const {
+    return attempts;
+}
+
+unsigned long FetchPolicy::getFailureCount() const {
+    return failures;
+}
+
+unsigned long FetchPolicy::getSuppressedCount() const {
+    return suppressed;
+}
+
+void FetchPolicy::logDecision(const char* reason) const {
+    Serial.printf("%s: %s (%d failed in a row) -> circuit %s, next try in %lu s | %lu attempts, %lu failed, %lu skipped\n",
+                  name, reason, consecutiveFailures, getStateName(), retryDelayMs / 1000,
+                  attempts, failures, suppressed);
+}
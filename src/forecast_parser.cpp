@@ -0,0 +1,317 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/forecast_parser.h"
+
+// Field slots in the openmeteo_sdk schema (weather_api.fbs)
+static const int FB_RESPONSE_HOURLY = 11;     // WeatherApiResponse.hourly
+static const int FB_SERIES_TIME = 0;          // VariablesWithTime.time
+static const int FB_SERIES_VARIABLES = 3;     // VariablesWithTime.variables
+static const int FB_VARIABLE_VALUES = 3;      // VariableWithValues.values
+
+// Size header in front of every block; 8 bytes keeps the payload aligned
+static const size_t BLOCK_HEADER = 8;
+
+CountingAllocator::CountingAllocator(ArduinoJson::Allocator* upstreamAllocator)
+    : upstream(upstreamAllocator), allocations(0), currentBytes(0), peakBytes(0) {
+}
+
+void CountingAllocator::track(size_t size) {
+    currentBytes += size;
+    if (currentBytes > peakBytes) peakBytes = currentBytes;
+}
+
+void* CountingAllocator::allocate(size_t size) {
+    size_t total = size + BLOCK_HEADER;
+    uint8_t* block = (uint8_t*)(upstream ? upstream->allocate(total) : malloc(total));
+    if (!block) return nullptr;
+
+    *(size_t*)block = size;
+    allocations++;
+    track(size);
+    return block + BLOCK_HEADER;
+}
+
+void CountingAllocator::deallocate(void* pointer) {
+    if (!pointer) return;
+    uint8_t* block = (uint8_t*)pointer - BLOCK_HEADER;
+    currentBytes -= *(size_t*)block;
+    if (upstream) {
+        upstream->deallocate(block);
+    } else {
+        free(block);
+    }
+}
+
+void* CountingAllocator::reallocate(void* pointer, size_t newSize) {
+    if (!pointer) return allocate(newSize);
+
+    uint8_t* block = (uint8_t*)pointer - BLOCK_HEADER;
+    size_t oldSize = *(size_t*)block;
+    size_t total = newSize + BLOCK_HEADER;
+    uint8_t* resized = (uint8_t*)(upstream ? upstream->reallocate(block, total) : realloc(block, total));
+    if (!resized) return nullptr;
+
+    *(size_t*)resized = newSize;
+    allocations++;
+    currentBytes -= oldSize;
+    track(newSize);
+    return resized + BLOCK_HEADER;
+}
+
+void CountingAllocator::reset() {
+    allocations = 0;
+    peakBytes = currentBytes;
+}
+
+bool ForecastParser::parse(const char* json, size_t length, ForecastSummary& summary,
+                           const char** error, ArduinoJson::Allocator* allocator, int locationIndex,
+                           ForecastSeries* series) {
+    JsonDocument doc(allocator);
+    return interpret(deserializeJson(doc, json, length), doc, summary, error, locationIndex, series);
+}
+
+bool ForecastParser::interpret(DeserializationError result, const JsonDocument& doc, ForecastSummary& summary,
+                               const char** error, int locationIndex, ForecastSeries* series) {
+    if (result) {
+        // IncompleteInput is what a truncated body produces
+        *error = result == DeserializationError::IncompleteInput ? "truncated response" : result.c_str();
+        return false;
+    }
+
+    // Several coordinates in one request return an array of location objects
+    JsonVariantConst root = doc.as<JsonVariantConst>();
+    if (root.is<JsonArrayConst>()) {
+        root = root[locationIndex];
+    }
+
+    JsonArrayConst heights = root["hourly"]["wave_height"];
+    if (heights.isNull() || heights.size() == 0) {
+        *error = "no wave data";
+        return false;
+    }
+
+    if (!summarize(heights, summary)) {
+        *error = "wave data is all null";
+        return false;
+    }
+
+    if (series) {
+        // ISO 8601 strings (the default time format) leave the start unknown
+        JsonVariantConst firstTime = root["hourly"]["time"][0];
+        series->startTime = firstTime.is<int64_t>() ? firstTime.as<int64_t>() : 0;
+        series->count = 0;
+        for (JsonVariantConst height : heights) {
+            if (series->count >= series->capacity) break;
+            series->heights[series->count++] = height.isNull() ? NAN : height.as<float>();
+        }
+    }
+    return true;
+}
+
+bool ForecastParser::summarize(JsonArrayConst heights, ForecastSummary& summary) {
+    summary.hours = heights.size();
+    summary.nullHours = 0;
+    summary.currentHeight = 0;
+
+    bool haveCurrent = false;
+    for (JsonVariantConst height : heights) {
+        if (height.isNull()) {
+            summary.nullHours++;
+        } else if (!haveCurrent) {
+            summary.currentHeight = height.as<float>();
+            haveCurrent = true;
+        }
+    }
+
+    summary.todayAverage = averageHeight(heights, FORECAST_TODAY_START_HOUR, FORECAST_TODAY_END_HOUR);
+    summary.tomorrowAverage = averageHeight(heights, FORECAST_TOMORROW_START_HOUR, FORECAST_TOMORROW_END_HOUR);
+    return haveCurrent;
+}
+
+float ForecastParser::averageHeight(JsonArrayConst heights, int startHour, int endHour) {
+    float sum = 0;
+    int count = 0;
+
+    for (int i = startHour; i < endHour && i < (int)heights.size(); i++) {
+        JsonVariantConst height = heights[i];
+        if (height.isNull()) continue;
+        sum += height.as<float>();
+        count++;
+    }
+
+    return count > 0 ? sum / count : 0;
+}
+
+// Minimal bounds-checked FlatBuffers reader over one message. Little-endian
+// loads go through memcpy so unaligned receive buffers are fine; any
+// out-of-range offset clears ok and makes later reads return 0.
+namespace {
+struct FlatReader {
+    const uint8_t* data;
+    size_t length;
+    bool ok;
+
+    bool inRange(size_t pos, size_t size) {
+        if (pos > length || size > length - pos) ok = false;
+        return ok;
+    }
+
+    uint32_t u32(size_t pos) {
+        uint32_t value = 0;
+        if (inRange(pos, sizeof(value))) memcpy(&value, data + pos, sizeof(value));
+        return value;
+    }
+
+    int64_t i64(size_t pos) {
+        int64_t value = 0;
+        if (inRange(pos, sizeof(value))) memcpy(&value, data + pos, sizeof(value));
+        return value;
+    }
+
+    uint16_t u16(size_t pos) {
+        uint16_t value = 0;
+        if (inRange(pos, sizeof(value))) memcpy(&value, data + pos, sizeof(value));
+        return value;
+    }
+
+    // Follow the uoffset stored at pos (tables, vectors, vector elements)
+    size_t deref(size_t pos) {
+        size_t target = pos + u32(pos);
+        inRange(target, 0);
+        return target;
+    }
+
+    // Position of a field inside a table, or 0 if the field is absent
+    size_t field(size_t table, int slot) {
+        int64_t vtable = (int64_t)table - (int32_t)u32(table);
+        if (vtable < 0 || !inRange((size_t)vtable, 4)) return 0;
+
+        size_t entry = 4 + 2 * slot;
+        if (entry + 2 > u16((size_t)vtable)) return 0;
+        uint16_t offset = u16((size_t)vtable + entry);
+        return ok && offset ? table + offset : 0;
+    }
+};
+}
+
+float FlatFloatVector::at(size_t index) const {
+    float value;
+    memcpy(&value, data + index * sizeof(float), sizeof(float));
+    return value;
+}
+
+bool ForecastParser::parseFlatBuffer(const uint8_t* data, size_t length, ForecastSummary& summary,
+                                     const char** error, int locationIndex, ForecastSeries* series) {
+    // Skip to this location's message
+    size_t start = 0;
+    for (int i = 0; ; i++) {
+        if (length - start < 4) {
+            *error = i == 0 ? "truncated response" : "no such location";
+            return false;
+        }
+        uint32_t size;
+        memcpy(&size, data + start, sizeof(size));
+        if (size > length - start - 4) {
+            *error = "truncated response";
+            return false;
+        }
+        if (i == locationIndex) {
+            length = size;
+            break;
+        }
+        start += 4 + size;
+    }
+
+    FlatReader reader = {data + start + 4, length, true};
+    size_t root = reader.deref(0);
+    size_t hourlyField = reader.field(root, FB_RESPONSE_HOURLY);
+    size_t hourly = hourlyField ? reader.deref(hourlyField) : 0;
+    size_t variablesField = hourly ? reader.field(hourly, FB_SERIES_VARIABLES) : 0;
+    size_t variables = variablesField ? reader.deref(variablesField) : 0;
+    if (!variables || reader.u32(variables) == 0) {
+        *error = reader.ok ? "no wave data" : "malformed response";
+        return false;
+    }
+
+    // Variables come back in request order and wave_height is the only one
+    size_t variable = reader.deref(variables + 4);
+    size_t valuesField = reader.field(variable, FB_VARIABLE_VALUES);
+    size_t values = valuesField ? reader.deref(valuesField) : 0;
+    uint32_t count = values ? reader.u32(values) : 0;
+    if (!reader.ok || count > length / sizeof(float) || !reader.inRange(values + 4, count * sizeof(float))) {
+        *error = "malformed response";
+        return false;
+    }
+    if (count == 0) {
+        *error = "no wave data";
+        return false;
+    }
+
+    FlatFloatVector heights = {reader.data + values + 4, count};
+    if (!summarize(heights, summary)) {
+        *error = "wave data is all null";
+        return false;
+    }
+
+    if (series) {
+        size_t timeField = reader.field(hourly, FB_SERIES_TIME);
+        series->startTime = timeField ? reader.i64(timeField) : 0;
+        series->count = 0;
+        for (size_t i = 0; i < heights.count && series->count < series->capacity; i++) {
+            series->heights[series->count++] = heights.at(i);
+        }
+    }
+    return true;
+}
+
+bool ForecastParser::summarize(const FlatFloatVector& heights, ForecastSummary& summary) {
+    summary.hours = heights.count;
+    summary.nullHours = 0;
+    summary.currentHeight = 0;
+
+    bool haveCurrent = false;
+    for (size_t i = 0; i < heights.count; i++) {
+        float height = heights.at(i);
+        if (isnan(height)) {
+            summary.nullHours++;
+        } else if (!haveCurrent) {
+            summary.currentHeight = height;
+            haveCurrent = true;
+        }
+    }
+
+    summary.todayAverage = averageHeight(heights, FORECAST_TODAY_START_HOUR, FORECAST_TODAY_END_HOUR);
+    summary.tomorrowAverage = averageHeight(heights, FORECAST_TOMORROW_START_HOUR, FORECAST_TOMORROW_END_HOUR);
+    return haveCurrent;
+}
+
+float ForecastParser::averageHeight(const FlatFloatVector& heights, int startHour, int endHour) {
+    float sum = 0;
+    int count = 0;
+
+    for (int i = startHour; i < endHour && i < (int)heights.count; i++) {
+        float height = heights.at(i);
+        if (isnan(height)) continue;
+        sum += height;
+        count++;
+    }
+
+    return count > 0 ? sum / count : 0;
+}
+
+float ForecastParser::metersToFeet(float meters) {
+    return meters * 3.28084;
+}
+
+const char* ForecastParser::getRating(float heightMeters) {
+    float heightFeet = metersToFeet(heightMeters);
+
+    if (heightFeet < 1.0) return "FLAT";
+    else if (heightFeet < 2.0) return "SMALL";
+    else if (heightFeet < 4.0) return "GOOD";
+    else if (heightFeet < 6.0) return "GREAT";
+    else if (heightFeet < 8.0) return "EPIC";
+    else return "HUGE";
+}
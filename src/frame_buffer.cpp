@@ -0,0 +1,239 @@
+#include <Arduino.h>
+#include "../include/frame_buffer.h"
+
+// Adafruit_GFX keeps its built-in 5x7 font file-static, so take our own copy
+#include <glcdfont.c>
+
+static const int16_t ROW_BYTES = FrameBuffer::NATIVE_WIDTH / 8;
+
+// Glyph rows are widened by repeating each bit; nibble tables cover text sizes 2-4
+static const uint8_t MAX_TABLE_SCALE = 4;
+
+static constexpr uint16_t spreadNibble(uint8_t nibble, uint8_t scale, int bit = 3) {
+    return bit < 0 ? 0
+        : (uint16_t)((((nibble >> bit) & 1) ? ((1u << scale) - 1) << (bit * scale) : 0)
+                     | spreadNibble(nibble, scale, bit - 1));
+}
+
+#define SPREAD_TABLE(scale) { \
+    spreadNibble(0, scale), spreadNibble(1, scale), spreadNibble(2, scale), spreadNibble(3, scale), \
+    spreadNibble(4, scale), spreadNibble(5, scale), spreadNibble(6, scale), spreadNibble(7, scale), \
+    spreadNibble(8, scale), spreadNibble(9, scale), spreadNibble(10, scale), spreadNibble(11, scale), \
+    spreadNibble(12, scale), spreadNibble(13, scale), spreadNibble(14, scale), spreadNibble(15, scale)}
+
+static const uint16_t NIBBLE_SPREAD[MAX_TABLE_SCALE - 1][16] = {SPREAD_TABLE(2), SPREAD_TABLE(3), SPREAD_TABLE(4)};
+
+// Each bit of an 8-bit glyph column repeated scale times, MSB first
+static uint32_t spreadBits(uint8_t bits, uint8_t scale) {
+    if (scale == 1) return bits;
+    const uint16_t* table = NIBBLE_SPREAD[scale - 2];
+    return ((uint32_t)table[bits >> 4] << (4 * scale)) | table[bits & 0x0F];
+}
+
+static inline void applyBits(uint8_t& target, uint8_t bits, uint16_t color) {
+    if (color == GxEPD_BLACK) {
+        target &= ~bits;
+    } else {
+        target |= bits;
+    }
+}
+
+FrameBuffer::FrameBuffer(uint8_t* storage) : Adafruit_GFX(NATIVE_WIDTH, NATIVE_HEIGHT), buffer(storage) {
+}
+
+void FrameBuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
+
+    // Same rotation mapping as GxEPD2_BW::drawPixel()
+    int16_t t;
+    switch (getRotation()) {
+        case 1:
+            t = x;
+            x = NATIVE_WIDTH - y - 1;
+            y = t;
+            break;
+        case 2:
+            x = NATIVE_WIDTH - x - 1;
+            y = NATIVE_HEIGHT - y - 1;
+            break;
+        case 3:
+            t = x;
+            x = y;
+            y = NATIVE_HEIGHT - t - 1;
+            break;
+    }
+
+    uint16_t i = x / 8 + y * (NATIVE_WIDTH / 8);
+    if (color == GxEPD_BLACK) {
+        buffer[i] &= ~(0x80 >> (x & 7));
+    } else {
+        buffer[i] |= (0x80 >> (x & 7));
+    }
+}
+
+void FrameBuffer::fillScreen(uint16_t color) {
+    memset(buffer, color == GxEPD_BLACK ? 0x00 : 0xFF, BUFFER_SIZE);
+}
+
+// Adafruit_GFX draws fast lines with writeLine(), so a length <= 0 still
+// plots from y + h - 1 back to y; normalize to that span to stay identical
+void FrameBuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (w <= 0) {
+        x += w - 1;
+        w = 2 - w;
+    }
+    fillRect(x, y, w, 1, color);
+}
+
+void FrameBuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (h <= 0) {
+        y += h - 1;
+        h = 2 - h;
+    }
+    fillRect(x, y, 1, h, color);
+}
+
+void FrameBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    // Adafruit_GFX fills column by column with drawFastVLine(), so w <= 0
+    // draws nothing while h <= 0 behaves as in drawFastVLine()
+    if (w <= 0) return;
+    if (h <= 0) {
+        y += h - 1;
+        h = 2 - h;
+    }
+
+    // Clip in logical coordinates
+    int32_t x0 = max<int32_t>(x, 0);
+    int32_t y0 = max<int32_t>(y, 0);
+    int32_t x1 = min<int32_t>((int32_t)x + w - 1, width() - 1);
+    int32_t y1 = min<int32_t>((int32_t)y + h - 1, height() - 1);
+    if (x0 > x1 || y0 > y1) return;
+
+    // A rotation maps the rectangle onto another rectangle in the native layout
+    switch (getRotation()) {
+        case 1:
+            fillNative(NATIVE_WIDTH - 1 - y1, x0, NATIVE_WIDTH - 1 - y0, x1, color);
+            break;
+        case 2:
+            fillNative(NATIVE_WIDTH - 1 - x1, NATIVE_HEIGHT - 1 - y1, NATIVE_WIDTH - 1 - x0, NATIVE_HEIGHT - 1 - y0, color);
+            break;
+        case 3:
+            fillNative(y0, NATIVE_HEIGHT - 1 - x1, y1, NATIVE_HEIGHT - 1 - x0, color);
+            break;
+        default:
+            fillNative(x0, y0, x1, y1, color);
+            break;
+    }
+}
+
+// Inclusive native-layout rectangle, already clipped
+void FrameBuffer::fillNative(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    int16_t firstByte = x0 >> 3;
+    int16_t lastByte = x1 >> 3;
+    uint8_t firstMask = 0xFF >> (x0 & 7);
+    uint8_t lastMask = 0xFF << (7 - (x1 & 7));
+    uint8_t fill = color == GxEPD_BLACK ? 0x00 : 0xFF;
+
+    uint8_t* row = buffer + y0 * ROW_BYTES;
+    for (int16_t y = y0; y <= y1; y++, row += ROW_BYTES) {
+        if (firstByte == lastByte) {
+            applyBits(row[firstByte], firstMask & lastMask, color);
+            continue;
+        }
+        applyBits(row[firstByte], firstMask, color);
+        memset(row + firstByte + 1, fill, lastByte - firstByte - 1);
+        applyBits(row[lastByte], lastMask, color);
+    }
+}
+
+size_t FrameBuffer::write(uint8_t c) {
+    if (gfxFont) return Adafruit_GFX::write(c);
+
+    // Same cursor handling as Adafruit_GFX::write() for the built-in font
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+        if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+            cursor_x = 0;
+            cursor_y += textsize_y * 8;
+        }
+        drawGlyph(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+        cursor_x += textsize_x * 6;
+    }
+    return 1;
+}
+
+// Blit a built-in font glyph. In landscape (rotation 1) each 8-pixel glyph
+// column lands on a native row, so a column becomes one widened bit pattern
+// written to sizeX rows with byte masks. Other rotations, sizes beyond the
+// tables and glyphs that are partly off-screen use Adafruit_GFX::drawChar().
+void FrameBuffer::drawGlyph(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                            uint8_t sizeX, uint8_t sizeY) {
+    int16_t cellWidth = 6 * sizeX;
+    int16_t cellHeight = 8 * sizeY;
+    if (getRotation() != 1 || sizeY > MAX_TABLE_SCALE || x < 0 || y < 0 ||
+        x + cellWidth > width() || y + cellHeight > height()) {
+        drawChar(x, y, c, color, bg, sizeX, sizeY);
+        return;
+    }
+
+    if (!_cp437 && (c >= 176)) c++; // Same quirk as drawChar()
+
+    // Glyph row j (top first) maps to native x = NATIVE_WIDTH - 1 - (y + j * sizeY),
+    // so MSB-first from nativeX the pattern runs bottom row to top row
+    int16_t nativeX = NATIVE_WIDTH - y - cellHeight;
+    int16_t firstByte = nativeX >> 3;
+    uint8_t shift = 64 - cellHeight - (nativeX & 7);
+    int byteCount = ((nativeX & 7) + cellHeight + 7) / 8;
+    uint64_t cellMask = (((uint64_t)1 << cellHeight) - 1) << (64 - cellHeight) >> (nativeX & 7);
+    bool opaque = bg != color;
+
+    // Column 5 is the gap between glyphs, only painted with an opaque background
+    for (int i = 0; i < (opaque ? 6 : 5); i++) {
+        uint8_t line = i < 5 ? pgm_read_byte(&font[c * 5 + i]) : 0;
+        if (!line && !opaque) continue;
+
+        // Bit 7 (the bottom row) is already the MSB; widen and align
+        uint64_t pattern = (uint64_t)spreadBits(line, sizeY) << shift;
+
+        uint8_t* row = buffer + (x + i * sizeX) * ROW_BYTES + firstByte;
+        for (int r = 0; r < sizeX; r++, row += ROW_BYTES) {
+            for (int k = 0; k < byteCount; k++) {
+                uint8_t ink = pattern >> (56 - 8 * k);
+                applyBits(row[k], ink, color);
+                if (opaque) {
+                    applyBits(row[k], (uint8_t)(cellMask >> (56 - 8 * k)) & ~ink, bg);
+                }
+            }
+        }
+    }
+}
+
+uint8_t* FrameBuffer::getBuffer() {
+    return buffer;
+}
+
+const uint8_t* FrameBuffer::getBuffer() const {
+    return buffer;
+}
+
+void FrameBuffer::copyFrom(const uint8_t* source) {
+    memcpy(buffer, source, BUFFER_SIZE);
+}
+
+void FrameBuffer::copyTo(uint8_t* destination) const {
+    memcpy(destination, buffer, BUFFER_SIZE);
+}
+
+void FrameBuffer::beginPage(const uint8_t* background) {
+    if (background) {
+        copyFrom(background);
+    } else {
+        fillScreen(GxEPD_WHITE);
+    }
+    setRotation(1); // Landscape orientation
+    setTextColor(GxEPD_BLACK);
+    setFont();
+    setTextSize(1);
+}
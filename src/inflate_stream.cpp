@@ -0,0 +1,183 @@
+#include <Arduino.h>
+#include "../include/inflate_stream.h"
+#include "../include/memory_report.h"
+
+// gzip header flags (RFC 1952)
+static const uint8_t GZIP_FHCRC = 0x02;
+static const uint8_t GZIP_FEXTRA = 0x04;
+static const uint8_t GZIP_FNAME = 0x08;
+static const uint8_t GZIP_FCOMMENT = 0x10;
+static const size_t GZIP_FIXED_HEADER = 10;
+
+InflateStream::InflateStream(Client& sourceClient, bool gzipEncoded)
+    : source(sourceClient), gzip(gzipEncoded), finished(false), error(false), moreOutput(false),
+      inflater(nullptr), window(nullptr), windowPos(0), output(nullptr), outPos(0), outEnd(0),
+      inPos(0), inEnd(0), headerState(FIXED), headerFlags(0), headerCount(0), extraLength(0),
+      compressedBytes(0), inflatedBytes(0) {
+    setTimeout(0); // read() already waits for the source; don't let Stream::timedRead() wait again
+}
+
+InflateStream::~InflateStream() {
+    MemoryReport::release(window);
+    MemoryReport::release(inflater);
+}
+
+bool InflateStream::begin() {
+    if (!gzip) return true;
+
+    // Only touched while a response is parsed, so both can live in PSRAM
+    inflater = (tinfl_decompressor*)MemoryReport::allocate("surf", "inflate state", sizeof(tinfl_decompressor),
+                                                           MemoryPlacement::PSRAM);
+    window = (uint8_t*)MemoryReport::allocate("surf", "inflate window", TINFL_LZ_DICT_SIZE, MemoryPlacement::PSRAM);
+    if (!inflater || !window) return false;
+
+    tinfl_init(inflater);
+    return true;
+}
+
+int InflateStream::available() {
+    return outEnd - outPos;
+}
+
+int InflateStream::read() {
+    if (!fill()) return -1;
+    inflatedBytes++;
+    return output[outPos++];
+}
+
+int InflateStream::peek() {
+    if (!fill()) return -1;
+    return output[outPos];
+}
+
+size_t InflateStream::readBytes(char* buffer, size_t length) {
+    size_t copied = 0;
+    while (copied < length && fill()) {
+        size_t count = min(length - copied, outEnd - outPos);
+        memcpy(buffer + copied, output + outPos, count);
+        outPos += count;
+        copied += count;
+    }
+    inflatedBytes += copied;
+    return copied;
+}
+
+bool InflateStream::readSource() {
+    // Wait for the next packet; with HTTP/1.0 the server closes after the body
+    unsigned long start = millis();
+    int count;
+    while ((count = source.available()) <= 0) {
+        if (!source.connected() || millis() - start > INFLATE_READ_TIMEOUT_MS) return false;
+        delay(1);
+    }
+
+    int received = source.read(input, min((size_t)count, sizeof(input)));
+    if (received <= 0) return false;
+    inPos = 0;
+    inEnd = received;
+    compressedBytes += received;
+    return true;
+}
+
+bool InflateStream::fill() {
+    while (outPos == outEnd) {
+        if (finished) return false;
+
+        if (!gzip) {
+            if (!readSource()) {
+                finished = true;
+                return false;
+            }
+            output = input;
+            outPos = inPos;
+            outEnd = inEnd;
+            inPos = inEnd;
+            continue;
+        }
+
+        if (inPos == inEnd && !moreOutput && !readSource()) {
+            // Connection ended before the deflate stream did
+            finished = true;
+            error = true;
+            return false;
+        }
+
+        if (headerState != DEFLATE) {
+            if (!skipHeader()) {
+                finished = true;
+                error = true;
+                return false;
+            }
+            continue;
+        }
+
+        size_t inSize = inEnd - inPos;
+        size_t outSize = TINFL_LZ_DICT_SIZE - windowPos;
+        tinfl_status status = tinfl_decompress(inflater, input + inPos, &inSize,
+                                               window, window + windowPos, &outSize,
+                                               TINFL_FLAG_HAS_MORE_INPUT);
+        inPos += inSize;
+        output = window;
+        outPos = windowPos;
+        outEnd = windowPos + outSize;
+        windowPos = (windowPos + outSize) & (TINFL_LZ_DICT_SIZE - 1);
+        moreOutput = status == TINFL_STATUS_HAS_MORE_OUTPUT;
+
+        if (status == TINFL_STATUS_DONE) {
+            finished = true; // The CRC32/size trailer is not needed by the reader
+        } else if (status < 0) {
+            finished = true;
+            error = true;
+        }
+    }
+    return true;
+}
+
+void InflateStream::advanceHeader() {
+    headerCount = 0;
+    for (;;) {
+        headerState = (HeaderState)(headerState + 1);
+        switch (headerState) {
+            case EXTRA_LENGTH: if (headerFlags & GZIP_FEXTRA) return; break;
+            case EXTRA: if (extraLength > 0) return; break;
+            case NAME: if (headerFlags & GZIP_FNAME) return; break;
+            case COMMENT: if (headerFlags & GZIP_FCOMMENT) return; break;
+            case HEADER_CRC: if (headerFlags & GZIP_FHCRC) return; break;
+            default: return; // DEFLATE
+        }
+    }
+}
+
+bool InflateStream::skipHeader() {
+    while (inPos < inEnd && headerState != DEFLATE) {
+        uint8_t value = input[inPos++];
+        switch (headerState) {
+            case FIXED:
+                // Magic 1f 8b, method 8 (deflate), then flags, mtime, xfl, os
+                if ((headerCount == 0 && value != 0x1f) || (headerCount == 1 && value != 0x8b) ||
+                    (headerCount == 2 && value != 8)) {
+                    return false;
+                }
+                if (headerCount == 3) headerFlags = value;
+                if (++headerCount == GZIP_FIXED_HEADER) advanceHeader();
+                break;
+            case EXTRA_LENGTH:
+                extraLength |= (size_t)value << (8 * headerCount);
+                if (++headerCount == 2) advanceHeader();
+                break;
+            case EXTRA:
+                if (++headerCount == extraLength) advanceHeader();
+                break;
+            case NAME:
+            case COMMENT:
+                if (value == 0) advanceHeader();
+                break;
+            case HEADER_CRC:
+                if (++headerCount == 2) advanceHeader();
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
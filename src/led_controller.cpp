@@ -1,29 +1,180 @@
 #include <Arduino.h>
 #include "../include/led_controller.h"
 
-LEDController::LEDController(int ledPin) : pin(ledPin), state(false) {
+static const LedStep OFF_PATTERN[] = {{0, false, 0}};
+static const LedStep ON_PATTERN[] = {{100, false, 0}};
+static const LedStep BOOTING_PATTERN[] = {{100, false, 100}, {0, false, 100}};
+static const LedStep OK_PATTERN[] = {{40, true, 1500}, {0, true, 1500}, {0, false, 1000}};
+static const LedStep WIFI_DOWN_PATTERN[] = {
+    {100, false, 150}, {0, false, 250}, {100, false, 150}, {0, false, 2000}
+};
+static const LedStep SENSOR_ERROR_PATTERN[] = {
+    {100, false, 150}, {0, false, 250}, {100, false, 150}, {0, false, 250}, {100, false, 150}, {0, false, 2000}
+};
+static const LedStep STALE_DATA_PATTERN[] = {{100, false, 800}, {0, false, 2500}};
+static const LedStep ALERT_PATTERN[] = {{100, true, 300}, {0, true, 300}};
+
+struct LedPattern {
+    const LedStep* steps;
+    uint8_t count;
+};
+
+#define LED_PATTERN(steps) {steps, sizeof(steps) / sizeof(steps[0])}
+
+// Indexed by LedStatus
+static const LedPattern STATUS_PATTERNS[] = {
+    LED_PATTERN(OFF_PATTERN),
+    LED_PATTERN(ON_PATTERN),
+    LED_PATTERN(BOOTING_PATTERN),
+    LED_PATTERN(OK_PATTERN),
+    LED_PATTERN(WIFI_DOWN_PATTERN),
+    LED_PATTERN(SENSOR_ERROR_PATTERN),
+    LED_PATTERN(STALE_DATA_PATTERN),
+    LED_PATTERN(ALERT_PATTERN),
+};
+static_assert(sizeof(STATUS_PATTERNS) / sizeof(STATUS_PATTERNS[0]) == (size_t)LedStatus::COUNT,
+              "every LedStatus needs a pattern");
+
+LEDController::LEDController(int ledPin)
+    : pin(ledPin), ready(false), status(LedStatus::OFF), steps(OFF_PATTERN), stepCount(1), stepIndex(0),
+      repeat(true), timerArmed(false), flashSteps(), timer(nullptr) {
+    mux = portMUX_INITIALIZER_UNLOCKED;
 }
 
 void LEDController::begin() {
-    pinMode(pin, OUTPUT);
-    off(); // Start with LED off
-    Serial.printf("LED Controller initialized on GPIO %d\n", pin);
+    ledc_timer_config_t timerConfig = {};
+    timerConfig.speed_mode = LED_LEDC_MODE;
+    timerConfig.duty_resolution = LED_PWM_RESOLUTION;
+    timerConfig.timer_num = LED_LEDC_TIMER;
+    timerConfig.freq_hz = LED_PWM_FREQUENCY_HZ;
+    timerConfig.clk_cfg = LEDC_AUTO_CLK;
+
+    ledc_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = pin;
+    channelConfig.speed_mode = LED_LEDC_MODE;
+    channelConfig.channel = LED_LEDC_CHANNEL;
+    channelConfig.timer_sel = LED_LEDC_TIMER;
+    channelConfig.duty = 0;
+    channelConfig.hpoint = 0;
+
+    if (ledc_timer_config(&timerConfig) != ESP_OK || ledc_channel_config(&channelConfig) != ESP_OK) {
+        Serial.printf("LED Controller: LEDC setup failed on GPIO %d\n", pin);
+        return;
+    }
+
+    // Already installed is fine - another driver may share the fade service
+    esp_err_t result = ledc_fade_func_install(0);
+    if (result != ESP_OK && result != ESP_ERR_INVALID_STATE) {
+        Serial.printf("LED Controller: fade service unavailable (%d)\n", result);
+        return;
+    }
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &LEDController::onTimer;
+    timerArgs.arg = this;
+    timerArgs.name = "led";
+    if (esp_timer_create(&timerArgs, &timer) != ESP_OK) {
+        Serial.println("LED Controller: could not create pattern timer");
+        return;
+    }
+
+    ready = true;
+    Serial.printf("LED Controller initialized on GPIO %d (LEDC channel %d)\n", pin, LED_LEDC_CHANNEL);
+    playStatus();
+}
+
+void LEDController::onTimer(void* arg) {
+    static_cast<LEDController*>(arg)->playNextStep();
+}
+
+void LEDController::playNextStep() {
+    portENTER_CRITICAL(&mux);
+    if (stepIndex >= stepCount) {
+        if (!repeat) {
+            // A flash has finished - go back to the status pattern
+            const LedPattern& pattern = STATUS_PATTERNS[(int)status];
+            steps = pattern.steps;
+            stepCount = pattern.count;
+            repeat = true;
+        }
+        stepIndex = 0;
+    }
+    LedStep step = steps[stepIndex++];
+    timerArmed = step.durationMs > 0;
+    portEXIT_CRITICAL(&mux);
+
+    uint32_t duty = LED_MAX_DUTY * step.level / 100;
+    if (step.fade) {
+        ledc_set_fade_time_and_start(LED_LEDC_MODE, LED_LEDC_CHANNEL, duty, step.durationMs, LEDC_FADE_NO_WAIT);
+    } else {
+        ledc_set_duty_and_update(LED_LEDC_MODE, LED_LEDC_CHANNEL, duty, 0);
+    }
+
+    if (step.durationMs > 0) {
+        esp_timer_start_once(timer, step.durationMs * 1000ULL);
+    }
+}
+
+void LEDController::play(const LedStep* pattern, uint8_t count, bool loop) {
+    if (!ready) return;
+
+    // A step in progress (possibly a hardware fade) is left to finish; the
+    // timer then picks up the new pattern. Only an idle LED is kicked now.
+    portENTER_CRITICAL(&mux);
+    steps = pattern;
+    stepCount = count;
+    stepIndex = 0;
+    repeat = loop;
+    bool idle = !timerArmed;
+    timerArmed = true;
+    portEXIT_CRITICAL(&mux);
+
+    if (idle) {
+        esp_timer_start_once(timer, 1);
+    }
+}
+
+void LEDController::playStatus() {
+    const LedPattern& pattern = STATUS_PATTERNS[(int)status];
+    play(pattern.steps, pattern.count, true);
+}
+
+void LEDController::setStatus(LedStatus newStatus) {
+    if (newStatus == status) return;
+
+    status = newStatus;
+    Serial.printf("LED status: %s\n", getStatusName(newStatus));
+    playStatus();
+}
+
+LedStatus LEDController::getStatus() const {
+    return status;
+}
+
+const char* LEDController::getStatusName(LedStatus status) {
+    switch (status) {
+        case LedStatus::OFF: return "off";
+        case LedStatus::ON: return "on";
+        case LedStatus::BOOTING: return "booting";
+        case LedStatus::OK: return "ok";
+        case LedStatus::WIFI_DOWN: return "WiFi down";
+        case LedStatus::SENSOR_ERROR: return "sensor error";
+        case LedStatus::STALE_DATA: return "stale data";
+        case LedStatus::ALERT: return "alert";
+        default: return "unknown";
+    }
 }
 
 void LEDController::on() {
-    digitalWrite(pin, HIGH);
-    state = true;
-    Serial.println("LED ON");
+    setStatus(LedStatus::ON);
 }
 
 void LEDController::off() {
-    digitalWrite(pin, LOW);
-    state = false;
-    Serial.println("LED OFF");
+    setStatus(LedStatus::OFF);
 }
 
 void LEDController::toggle() {
-    if (state) {
+    if (getState()) {
         off();
     } else {
         on();
@@ -31,12 +182,16 @@ void LEDController::toggle() {
 }
 
 void LEDController::flash(int delayMs) {
-    on();
-    delay(delayMs);
-    off();
-    delay(delayMs);
+    uint16_t durationMs = constrain(delayMs, 1, 65535);
+
+    portENTER_CRITICAL(&mux);
+    flashSteps[0] = {100, false, durationMs};
+    flashSteps[1] = {0, false, durationMs};
+    portEXIT_CRITICAL(&mux);
+
+    play(flashSteps, 2, false);
 }
 
 bool LEDController::getState() const {
-    return state;
+    return status != LedStatus::OFF;
 }
@@ -0,0 +1,263 @@
+#include <Arduino.h>
+#include <math.h>
+#include "../include/location_catalog.h"
+
+static const float EARTH_RADIUS_KM = 6371.0f;
+static const float KM_PER_DEGREE = EARTH_RADIUS_KM * (float)M_PI / 180.0f;
+
+// Used until a catalog partition is flashed; names live in rodata, not on the heap
+static const SurfLocation builtinLocations[] = {
+    {50.425998f, -5.103096f, "Cribbar, Newquay"},
+    {50.079780f, -5.698678f, "Sennen Cove"},
+    {50.229620f, -5.394250f, "Gwithian"},
+    {50.445738f, -5.045831f, "Watergate Bay"},
+    {50.042637f, -5.649877f, "Porthcurno"},
+    {51.115862f, -4.227910f, "Saunton Sands"},
+    {51.130414f, -4.238428f, "Croyde Bay"}
+};
+static const uint32_t BUILTIN_COUNT = sizeof(builtinLocations) / sizeof(builtinLocations[0]);
+
+static uint32_t fnv1a(const uint8_t* bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// True if count records of size bytes starting at offset fit in length
+static bool fits(uint32_t offset, uint32_t count, size_t size, uint32_t length) {
+    return offset <= length && count <= (length - offset) / size;
+}
+
+LocationCatalog::LocationCatalog()
+    : header(nullptr), cells(nullptr), spots(nullptr), names(nullptr),
+      rows(0), columns(0), mapping(0), mapped(false) {
+}
+
+LocationCatalog::~LocationCatalog() {
+    end();
+}
+
+bool LocationCatalog::begin() {
+    if (mapped) return true;
+
+    const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                LOCATION_CATALOG_PARTITION);
+    if (!partition) {
+        Serial.println("No catalog partition - using the built-in surf spots");
+        return false;
+    }
+
+    // Map only what the catalog uses; the header says how much that is
+    CatalogHeader probe;
+    if (esp_partition_read(partition, 0, &probe, sizeof(probe)) != ESP_OK ||
+        memcmp(probe.magic, "SPOT", 4) != 0 || probe.totalSize > partition->size) {
+        Serial.println("Catalog partition is empty or invalid - using the built-in surf spots");
+        return false;
+    }
+
+    const void* image = nullptr;
+    if (esp_partition_mmap(partition, 0, probe.totalSize, SPI_FLASH_MMAP_DATA, &image, &mapping) != ESP_OK) {
+        Serial.println("Could not map the catalog partition - using the built-in surf spots");
+        return false;
+    }
+
+    unsigned long start = micros();
+    if (!attach((const uint8_t*)image, probe.totalSize)) {
+        spi_flash_munmap(mapping);
+        return false;
+    }
+    mapped = true;
+    Serial.printf("Location catalog: %u spots in %u cells (%.2f deg), %u bytes mapped, checked in %lu us\n",
+                  (unsigned)header->spotCount, (unsigned)header->cellCount, header->cellSize,
+                  (unsigned)header->totalSize, micros() - start);
+    return true;
+}
+
+void LocationCatalog::end() {
+    if (mapped) {
+        spi_flash_munmap(mapping);
+        mapped = false;
+    }
+    header = nullptr;
+}
+
+bool LocationCatalog::attach(const uint8_t* image, size_t length) {
+    const CatalogHeader* candidate = (const CatalogHeader*)image;
+    const char* problem = nullptr;
+
+    if (length < sizeof(CatalogHeader) || memcmp(candidate->magic, "SPOT", 4) != 0) {
+        problem = "bad magic";
+    } else if (candidate->version != LOCATION_CATALOG_VERSION || candidate->headerSize != sizeof(CatalogHeader)) {
+        problem = "unsupported version";
+    } else if (candidate->totalSize > length ||
+               !fits(candidate->cellsOffset, candidate->cellCount, sizeof(CatalogCell), candidate->totalSize) ||
+               !fits(candidate->spotsOffset, candidate->spotCount, sizeof(CatalogSpot), candidate->totalSize) ||
+               !fits(candidate->namesOffset, candidate->namesSize, 1, candidate->totalSize) ||
+               candidate->namesSize == 0 || image[candidate->namesOffset + candidate->namesSize - 1] != 0 ||
+               (candidate->cellsOffset | candidate->spotsOffset) % 4 != 0) {
+        problem = "sections out of range";
+    } else if (!(candidate->cellSize > 0.0f && candidate->cellSize <= 90.0f)) {
+        problem = "bad cell size";
+    } else if (fnv1a(image + sizeof(CatalogHeader), candidate->totalSize - sizeof(CatalogHeader)) != candidate->checksum) {
+        problem = "checksum mismatch";
+    }
+
+    if (!problem) {
+        const CatalogCell* cellTable = (const CatalogCell*)(image + candidate->cellsOffset);
+        for (uint32_t i = 0; i < candidate->cellCount && !problem; i++) {
+            if (cellTable[i].firstSpot > candidate->spotCount ||
+                cellTable[i].spotCount > candidate->spotCount - cellTable[i].firstSpot ||
+                (i > 0 && cellTable[i].key <= cellTable[i - 1].key)) {
+                problem = "bad cell index";
+            }
+        }
+    }
+
+    if (problem) {
+        Serial.printf("Location catalog rejected (%s) - using the built-in surf spots\n", problem);
+        return false;
+    }
+
+    header = candidate;
+    cells = (const CatalogCell*)(image + header->cellsOffset);
+    spots = (const CatalogSpot*)(image + header->spotsOffset);
+    names = (const char*)(image + header->namesOffset);
+    rows = (uint32_t)ceilf(180.0f / header->cellSize);
+    columns = (uint32_t)ceilf(360.0f / header->cellSize);
+    return true;
+}
+
+bool LocationCatalog::isMapped() const {
+    return header != nullptr;
+}
+
+uint32_t LocationCatalog::size() const {
+    return header ? header->spotCount : BUILTIN_COUNT;
+}
+
+SurfLocation LocationCatalog::get(uint32_t index) const {
+    if (!header) {
+        return index < BUILTIN_COUNT ? builtinLocations[index] : SurfLocation{0, 0, "?"};
+    }
+    if (index >= header->spotCount) return SurfLocation{0, 0, "?"};
+
+    const CatalogSpot& spot = spots[index];
+    const char* name = spot.nameOffset < header->namesSize ? names + spot.nameOffset : "?";
+    return SurfLocation{spot.latitude, spot.longitude, name};
+}
+
+uint32_t LocationCatalog::rowOf(float latitude) const {
+    int row = (int)floorf((latitude + 90.0f) / header->cellSize);
+    return row < 0 ? 0 : (row >= (int)rows ? rows - 1 : row);
+}
+
+uint32_t LocationCatalog::columnOf(float longitude) const {
+    int column = (int)floorf((longitude + 180.0f) / header->cellSize) % (int)columns;
+    return column < 0 ? column + columns : column;
+}
+
+const CatalogCell* LocationCatalog::findCell(uint32_t key) const {
+    uint32_t low = 0, high = header->cellCount;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (cells[middle].key < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low < header->cellCount && cells[low].key == key ? &cells[low] : nullptr;
+}
+
+// Keeps the best count candidates sorted, nearest first
+static void offer(uint32_t index, float distance, int count, int& found, uint32_t* indices, float* distances) {
+    if (found == count && distance >= distances[found - 1]) return;
+
+    int position = found < count ? found++ : count - 1;
+    while (position > 0 && distances[position - 1] > distance) {
+        indices[position] = indices[position - 1];
+        distances[position] = distances[position - 1];
+        position--;
+    }
+    indices[position] = index;
+    distances[position] = distance;
+}
+
+int LocationCatalog::findNearest(float latitude, float longitude, int count, uint32_t* indices,
+                                 float* distancesKm) const {
+    if (count <= 0) return 0;
+
+    float scratch[16];
+    float* distances = distancesKm;
+    if (!distances) {
+        if (count > 16) count = 16;
+        distances = scratch;
+    }
+    int found = 0;
+
+    if (!header) {
+        for (uint32_t i = 0; i < BUILTIN_COUNT; i++) {
+            offer(i, distanceKm(latitude, longitude, builtinLocations[i].latitude, builtinLocations[i].longitude),
+                  count, found, indices, distances);
+        }
+        return found;
+    }
+
+    // Walk square rings of cells outwards from the position's cell. A spot in
+    // ring r is at least r - 1 whole cells away in latitude or longitude, so
+    // once that distance passes the current worst candidate no further ring
+    // can improve the result.
+    int originRow = (int)rowOf(latitude);
+    int originColumn = (int)columnOf(longitude);
+    int westSpan = ((int)columns - 1) / 2;    // Column offsets that reach each column exactly once
+    int eastSpan = (int)columns / 2;
+    int lastRing = (int)rows > eastSpan ? (int)rows : eastSpan;
+    const float toRadians = (float)M_PI / 180.0f;
+
+    for (int ring = 0; ring <= lastRing; ring++) {
+        if (found == count && ring > 1) {
+            float spread = (ring - 1) * header->cellSize;
+            float bound = spread * KM_PER_DEGREE;
+            if (ring <= eastSpan) {
+                // Side columns: the nearest point that far east or west lies on that
+                // meridian (cross-track distance), which shrinks towards the poles
+                float across = EARTH_RADIUS_KM * asinf(cosf(latitude * toRadians) *
+                                                       sinf((spread < 90.0f ? spread : 90.0f) * toRadians));
+                if (across < bound) bound = across;
+            }
+            if (bound >= distances[found - 1]) break;
+        }
+
+        int west = ring < westSpan ? ring : westSpan;
+        int east = ring < eastSpan ? ring : eastSpan;
+        for (int row = originRow - ring; row <= originRow + ring; row++) {
+            if (row < 0 || row >= (int)rows) continue;
+            bool edgeRow = row == originRow - ring || row == originRow + ring;
+            for (int offset = -west; offset <= east; offset++) {
+                // Off the edge rows only the ring's two side columns are new
+                if (!edgeRow && offset != -ring && offset != ring) continue;
+                uint32_t column = (uint32_t)((originColumn + offset + (int)columns) % (int)columns);
+                const CatalogCell* cell = findCell(row * columns + column);
+                if (!cell) continue;
+                for (uint32_t i = 0; i < cell->spotCount; i++) {
+                    uint32_t index = cell->firstSpot + i;
+                    offer(index, distanceKm(latitude, longitude, spots[index].latitude, spots[index].longitude),
+                          count, found, indices, distances);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+float LocationCatalog::distanceKm(float latitude1, float longitude1, float latitude2, float longitude2) {
+    const float toRadians = (float)M_PI / 180.0f;
+    float dLatitude = (latitude2 - latitude1) * toRadians;
+    float dLongitude = (longitude2 - longitude1) * toRadians;
+    float a = sinf(dLatitude / 2) * sinf(dLatitude / 2) +
+              cosf(latitude1 * toRadians) * cosf(latitude2 * toRadians) * sinf(dLongitude / 2) * sinf(dLongitude / 2);
+    return 2 * EARTH_RADIUS_KM * asinf(sqrtf(a > 1.0f ? 1.0f : a));
+}
@@ -1,7 +1,12 @@
 #include <Arduino.h>
 #include "../include/led_controller.h"
 #include "../include/epaper_display.h"
+#include "../include/panel_group.h"
 #include "../include/time_utils.h"
+#include "../include/telemetry_publisher.h"
+#include "../include/energy_monitor.h"
+#include "../include/memory_report.h"
+#include "../include/rule_engine.h"
 
 // Deployment mode selection via build flags
 // Available modes: DEPLOYMENT_TEMPERATURE_HUMIDITY or DEPLOYMENT_SURF_FORECAST
@@ -32,10 +37,57 @@
 const char* WIFI_SSID = "EE-38NJQK";
 const char* WIFI_PASSWORD = "uT6TAJ7wtRVYgquP";
 
+// Telemetry listener: InfluxDB line protocol over UDP with timestamps in seconds, e.g. Telegraf
+// socket_listener with service_address = "udp://:8094", data_format = "influx" and
+// influx_timestamp_precision = "1s", or an InfluxDB 1.x [[udp]] listener with precision = "s"
+// Leave the host empty to disable publishing
+const char* TELEMETRY_HOST = "";
+const uint16_t TELEMETRY_PORT = 8094;
+const char* TELEMETRY_DEVICE_ID = "esp32-lab";
+
+// Energy report printed to serial and published to telemetry
+// Send 'e' over serial for an on-demand energy report, 'm' for a memory report,
+// 'r' for alert rule statistics ('s' lists the best upcoming surf sessions in surf mode)
+const unsigned long ENERGY_REPORT_INTERVAL_MS = 15 * 60 * 1000; // 15 minutes
+
+// Longest the loop sleeps between passes. It wakes sooner when the sensor is
+// due earlier, e.g. a fetch retry after FETCH_BACKOFF_BASE_MS.
+const unsigned long LOOP_MAX_IDLE_MS = 10000; // 10 seconds
+
+// Alert rules, compiled once at boot (syntax in include/rule_engine.h). Actions:
+// led = alert LED pattern while active, display = alert page on the panel,
+// hook = "alert" telemetry event when raised and when cleared
+#ifdef DEPLOYMENT_TEMPERATURE_HUMIDITY
+const char* const ALERT_RULES[] = {
+    "humidity > 70 for 2h => led display hook",
+    "temperature rises 3 within 1h => led hook",
+};
+const int ALERT_RULE_KEYS = 1;
+#endif
+
+#ifdef DEPLOYMENT_SURF_FORECAST
+const char* const ALERT_RULES[] = {
+    "rating SMALL -> GREAT => led display hook",   // At any spot in the rotation
+    "wave > 8 for 6h => hook",
+};
+const int ALERT_RULE_KEYS = MAX_CAROUSEL_FRAMES;
+#endif
+
+// An alert page stays up this long before regular refreshes resume
+const unsigned long ALERT_DISPLAY_HOLD_MS = 5 * 60 * 1000; // 5 minutes
+
 // Create module instances
 LEDController led(LED_PIN);
 EPaperDisplay epaperDisplay(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY);
 
+// Further panels share SPI and DC and need their own CS, RST and BUSY pins, e.g.
+// EPaperDisplay spotPanel2(26, EPD_DC, 27, 33); added below with panels.add().
+// In surf mode each panel then shows one spot instead of the carousel.
+PanelGroup panels;
+TelemetryPublisher telemetry;
+RuleEngine rules;
+unsigned long alertShownAt = 0; // millis() when an alert page went up, 0 if none
+
 // Create sensor instance based on deployment mode
 #ifdef DEPLOYMENT_TEMPERATURE_HUMIDITY
 TemperatureHumiditySensor sensor(&epaperDisplay, 13);  // DHT11 on pin 13
@@ -47,9 +99,16 @@ SurfForecast sensor(&epaperDisplay);  // Surf forecast with WiFi
 
 // put function declarations here:
 int myFunction(int, int);
+LedStatus currentLedStatus();
+void onAlert(const RuleEvent& event);
+void showAlert(const RuleEvent& event);
 
 void setup() {
     // put your setup code here, to run once:
+
+    // Start energy accounting first so setup itself is counted
+    EnergyMonitor::begin();
+    EnergyScope active(PowerState::CPU_ACTIVE);
     
     // Initialize serial communication for debugging
     Serial.begin(115200);
@@ -57,18 +116,37 @@ void setup() {
     Serial.println("ESP32 Modular Sensor Display Started!");
     Serial.println("Using MODULAR CODE STRUCTURE!");
     
-    // Initialize LED controller
+    // Initialize LED controller; it blinks until the first status is posted
     led.begin();
+    led.setStatus(LedStatus::BOOTING);
 
     // Initialize NTP time sync
     TimeUtils::begin();
 
-    // Initialize e-paper display
-    epaperDisplay.begin();
+    // Initialize e-paper panels; frames refresh in the background so sampling
+    // and fetching keep running
+    panels.add(&epaperDisplay);
+    panels.begin();
     
-    // Show initial message
-    epaperDisplay.showText("Starting...", 10, 30, 2);
+    // Initialize telemetry before the sensor so the first reading is queued
+    telemetry.begin(TELEMETRY_HOST, TELEMETRY_PORT, TELEMETRY_DEVICE_ID);
+    sensor.setTelemetry(&telemetry);
     
+    // Rules are evaluated on every sample from here on
+    rules.compile(ALERT_RULES, sizeof(ALERT_RULES) / sizeof(ALERT_RULES[0]), ALERT_RULE_KEYS);
+    rules.setHandler(onAlert);
+    sensor.setRuleEngine(&rules);
+#ifdef DEPLOYMENT_SURF_FORECAST
+    sensor.setPanelGroup(&panels);
+    sensor.selectNearestSpots(SURF_HOME_LATITUDE, SURF_HOME_LONGITUDE, SURF_ROTATION_SIZE);
+#endif
+
+    // Last good data from before the reset goes up straight away (no refresh at
+    // all if the panel still shows it); the splash only when nothing was saved
+    if (!sensor.restoreSnapshot()) {
+        epaperDisplay.showText("Starting...", 10, 30, 2);
+    }
+
     // Initialize sensor (connects to WiFi and fetches/reads data)
     sensor.begin(WIFI_SSID, WIFI_PASSWORD);
 
@@ -78,26 +156,35 @@ void setup() {
     int result = myFunction(2, 3);
     Serial.printf("myFunction result: %d\n", result);
     
+    MemoryReport::registerTask(xTaskGetCurrentTaskHandle());
+    MemoryReport::print();
+    
     Serial.println("Setup completed! Starting main loop...");
 }
 
 void loop() {
     // put your main code here, to run repeatedly:
-
-    // Keep LED on to show the ESP32 is running
-    led.on();
+    EnergyMonitor::enter(PowerState::CPU_ACTIVE);
+    EnergyMonitor::setActive(PowerState::RADIO_ASSOCIATED, WiFi.status() == WL_CONNECTED);
 
     // Update sensor data periodically (handles its own timing)
     sensor.update();
 
+    // Send queued telemetry once a full batch is ready
+    telemetry.loop();
+
+    // Post the status; the LED pattern plays on its own until it changes
+    led.setStatus(currentLedStatus());
     
     // Refresh display every 30 seconds when sensor data is ready
     static unsigned long lastDisplayUpdate = 0;
     unsigned long currentTime = millis();
     const unsigned long DISPLAY_REFRESH_INTERVAL_MS = 30000; // 30 seconds
 
-    // Simple refresh logic: update every 30 seconds after first display
-    bool shouldRefresh = sensor.isDataReady() &&
+    // Simple refresh logic: update every 30 seconds after first display,
+    // unless an alert page is being held on the panel
+    bool alertHeld = alertShownAt != 0 && currentTime - alertShownAt < ALERT_DISPLAY_HOLD_MS;
+    bool shouldRefresh = sensor.isDataReady() && !alertHeld &&
         (lastDisplayUpdate == 0 ||
          (currentTime - lastDisplayUpdate) >= DISPLAY_REFRESH_INTERVAL_MS);
 
@@ -106,11 +193,88 @@ void loop() {
         Serial.println("Display refreshed with current sensor data");
         lastDisplayUpdate = currentTime;
     }
-    
-    delay(10000); // Check every 10 seconds
+
+    // Reports on request over serial; the energy report also runs periodically
+    static unsigned long lastEnergyReport = 0;
+    bool reportRequested = false;
+    while (Serial.available()) {
+        int command = Serial.read();
+        if (command == 'e') reportRequested = true;
+        if (command == 'm') MemoryReport::print();
+        if (command == 'r') rules.printStats();
+#ifdef DEPLOYMENT_SURF_FORECAST
+        if (command == 's') sensor.printBestSessions();
+#endif
+    }
+    if (reportRequested || currentTime - lastEnergyReport >= ENERGY_REPORT_INTERVAL_MS) {
+        EnergyMonitor::printReport();
+        EnergyMonitor::publish(telemetry);
+        lastEnergyReport = currentTime;
+    }
+
+    EnergyMonitor::exit(PowerState::CPU_ACTIVE);
+    delay(min(sensor.getTimeUntilUpdate(millis()), LOOP_MAX_IDLE_MS)); // Counted as idle
 }
 
 // put function definitions here:
 int myFunction(int x, int y) {
     return x + y;
+}
+
+// Most urgent condition first
+LedStatus currentLedStatus() {
+    if (WiFi.status() != WL_CONNECTED) return LedStatus::WIFI_DOWN;
+    if (sensor.hasError()) return LedStatus::SENSOR_ERROR;
+    if (rules.isAlertActive(RULE_ACTION_LED)) return LedStatus::ALERT;
+    if (sensor.isDataStale()) return LedStatus::STALE_DATA;
+    return LedStatus::OK;
+}
+
+// Raised and cleared alerts; the LED follows isAlertActive() on its own
+void onAlert(const RuleEvent& event) {
+    if (event.compiled->actions & RULE_ACTION_HOOK) {
+        telemetry.record("alert", event.label,
+                         "rule", event.rule + 1,
+                         "value", event.value,
+                         "active", event.active ? 1 : 0);
+    }
+    if ((event.compiled->actions & RULE_ACTION_DISPLAY) && event.active) {
+        showAlert(event);
+    }
+}
+
+void showAlert(const RuleEvent& event) {
+    // The rule's condition, without its actions
+    char condition[RULE_TEXT_LENGTH];
+    strlcpy(condition, event.compiled->text, sizeof(condition));
+    char* actions = strstr(condition, "=>");
+    if (actions) *actions = '\0';
+    
+    char value[32];
+    if (event.compiled->signal == RuleSignal::SURF_RATING) {
+        snprintf(value, sizeof(value), "Now %s", RuleEngine::getRatingName((int)event.value));
+    } else {
+        snprintf(value, sizeof(value), "Now %.1f", event.value);
+    }
+    
+    Adafruit_GFX* gfx = epaperDisplay.beginFrame();
+    gfx->setTextSize(2);
+    gfx->setCursor(2, 6);
+    gfx->print("ALERT");
+    gfx->setTextSize(1);
+    gfx->setCursor(2, 40);
+    gfx->print(event.label);
+    gfx->setCursor(2, 56);
+    gfx->print(condition);
+    gfx->setTextSize(2);
+    gfx->setCursor(2, 76);
+    gfx->print(value);
+    gfx->setTextSize(1);
+    gfx->setCursor(2, 114);
+    gfx->print("Since " + TimeUtils::getCurrentTimestamp());
+    epaperDisplay.endFrame();
+    alertShownAt = millis();
+    
+    // So the first refresh after the hold puts the sensor's page back
+    sensor.invalidateDisplay();
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include "../include/memory_report.h"
+
+struct BufferEntry {
+    const char* subsystem;
+    const char* name;
+    const void* pointer;
+    size_t bytes;
+    MemoryPlacement placement; // Where it actually ended up
+};
+
+// Plain arrays so registration also works from global constructors
+static portMUX_TYPE registryMux = portMUX_INITIALIZER_UNLOCKED;
+static BufferEntry buffers[MEMORY_REPORT_MAX_BUFFERS];
+static int bufferCount = 0;
+static TaskHandle_t tasks[MEMORY_REPORT_MAX_TASKS];
+static int taskCount = 0;
+
+static uint32_t capsFor(MemoryPlacement placement) {
+    return placement == MemoryPlacement::PSRAM ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+                                               : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+static BufferEntry* findEntry(const void* pointer) {
+    for (int i = 0; i < bufferCount; i++) {
+        if (buffers[i].pointer == pointer) return &buffers[i];
+    }
+    return nullptr;
+}
+
+void* MemoryReport::allocate(const char* subsystem, const char* name, size_t bytes, MemoryPlacement placement) {
+    if (placement == MemoryPlacement::PSRAM && !psramFound()) {
+        placement = MemoryPlacement::INTERNAL;
+    }
+
+    void* pointer = heap_caps_malloc(bytes, capsFor(placement));
+    if (pointer) {
+        registerBuffer(subsystem, name, pointer, bytes, placement);
+    }
+    return pointer;
+}
+
+void* MemoryReport::reallocate(void* pointer, size_t bytes) {
+    portENTER_CRITICAL(&registryMux);
+    BufferEntry* entry = findEntry(pointer);
+    MemoryPlacement placement = entry ? entry->placement : MemoryPlacement::INTERNAL;
+    portEXIT_CRITICAL(&registryMux);
+
+    // Stay in the same kind of memory as the original block
+    void* resized = heap_caps_realloc(pointer, bytes, capsFor(placement));
+    if (resized) {
+        portENTER_CRITICAL(&registryMux);
+        entry = findEntry(pointer);
+        if (entry) {
+            entry->pointer = resized;
+            entry->bytes = bytes;
+        }
+        portEXIT_CRITICAL(&registryMux);
+    }
+    return resized;
+}
+
+void MemoryReport::release(void* pointer) {
+    if (!pointer) return;
+
+    portENTER_CRITICAL(&registryMux);
+    BufferEntry* entry = findEntry(pointer);
+    if (entry) {
+        *entry = buffers[--bufferCount];
+    }
+    portEXIT_CRITICAL(&registryMux);
+
+    heap_caps_free(pointer);
+}
+
+void MemoryReport::registerBuffer(const char* subsystem, const char* name, const void* pointer,
+                                  size_t bytes, MemoryPlacement placement) {
+    portENTER_CRITICAL(&registryMux);
+    if (bufferCount < MEMORY_REPORT_MAX_BUFFERS) {
+        buffers[bufferCount++] = {subsystem, name, pointer, bytes, placement};
+    }
+    portEXIT_CRITICAL(&registryMux);
+}
+
+void MemoryReport::registerTask(TaskHandle_t task) {
+    portENTER_CRITICAL(&registryMux);
+    if (task && taskCount < MEMORY_REPORT_MAX_TASKS) {
+        tasks[taskCount++] = task;
+    }
+    portEXIT_CRITICAL(&registryMux);
+}
+
+const char* MemoryReport::placementName(MemoryPlacement placement) {
+    switch (placement) {
+        case MemoryPlacement::INTERNAL: return "internal";
+        case MemoryPlacement::PSRAM: return "PSRAM";
+        default: return "static";
+    }
+}
+
+void MemoryReport::print() {
+    const uint32_t INTERNAL_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+
+    Serial.println("Memory report:");
+    Serial.printf("  Internal: %u free of %u B, min free %u B, largest block %u B\n",
+                  heap_caps_get_free_size(INTERNAL_CAPS), heap_caps_get_total_size(INTERNAL_CAPS),
+                  heap_caps_get_minimum_free_size(INTERNAL_CAPS), heap_caps_get_largest_free_block(INTERNAL_CAPS));
+    if (psramFound()) {
+        Serial.printf("  PSRAM:    %u free of %u B, min free %u B, largest block %u B\n",
+                      heap_caps_get_free_size(MALLOC_CAP_SPIRAM), heap_caps_get_total_size(MALLOC_CAP_SPIRAM),
+                      heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM), heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+    } else {
+        Serial.println("  PSRAM:    not found");
+    }
+
+    // Snapshot the registry so printing does not hold the lock
+    BufferEntry snapshot[MEMORY_REPORT_MAX_BUFFERS];
+    portENTER_CRITICAL(&registryMux);
+    int count = bufferCount;
+    memcpy(snapshot, buffers, count * sizeof(BufferEntry));
+    portEXIT_CRITICAL(&registryMux);
+
+    Serial.println("  Buffers:");
+    for (int i = 0; i < count; i++) {
+        Serial.printf("    %-10s %-22s %7u B  %s\n", snapshot[i].subsystem, snapshot[i].name,
+                      snapshot[i].bytes, placementName(snapshot[i].placement));
+    }
+
+    Serial.println("  Per subsystem (internal / PSRAM / static):");
+    for (int i = 0; i < count; i++) {
+        // Only the first entry of each subsystem prints its totals
+        bool seen = false;
+        for (int j = 0; j < i && !seen; j++) {
+            seen = strcmp(snapshot[j].subsystem, snapshot[i].subsystem) == 0;
+        }
+        if (seen) continue;
+
+        size_t totals[3] = {0, 0, 0};
+        for (int j = i; j < count; j++) {
+            if (strcmp(snapshot[j].subsystem, snapshot[i].subsystem) == 0) {
+                totals[(int)snapshot[j].placement] += snapshot[j].bytes;
+            }
+        }
+        Serial.printf("    %-10s %7u / %7u / %7u B\n", snapshot[i].subsystem, totals[0], totals[1], totals[2]);
+    }
+
+    // ESP-IDF reports stack high-water marks in bytes
+    Serial.println("  Task stacks (minimum free):");
+    for (int i = 0; i < taskCount; i++) {
+        Serial.printf("    %-16s %5u B\n", pcTaskGetTaskName(tasks[i]), uxTaskGetStackHighWaterMark(tasks[i]));
+    }
+}
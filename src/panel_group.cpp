@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include "../include/panel_group.h"
+
+PanelGroup::PanelGroup() : panels(), pending(), panelCount(0), commitStart(0) {
+}
+
+bool PanelGroup::add(EPaperDisplay* panel) {
+    if (!panel || panelCount >= MAX_PANELS) {
+        Serial.printf("Panel group is full (%d panels)\n", MAX_PANELS);
+        return false;
+    }
+    panels[panelCount++] = panel;
+    return true;
+}
+
+void PanelGroup::begin() {
+    for (int i = 0; i < panelCount; i++) {
+        panels[i]->begin();
+        panels[i]->setAsyncRefresh(true);
+    }
+    Serial.printf("Panel group ready with %d panel(s) on the shared SPI bus\n", panelCount);
+}
+
+int PanelGroup::getPanelCount() const {
+    return panelCount;
+}
+
+EPaperDisplay* PanelGroup::getPanel(int index) {
+    return index >= 0 && index < panelCount ? panels[index] : nullptr;
+}
+
+Adafruit_GFX* PanelGroup::beginFrame(int index, bool useStaticLayer) {
+    if (index < 0 || index >= panelCount) return nullptr;
+    pending[index] = true;
+    return panels[index]->beginFrame(useStaticLayer);
+}
+
+void PanelGroup::noteCommit() {
+    if (!isRefreshing()) {
+        commitStart = millis();
+    }
+}
+
+void PanelGroup::commit(int index) {
+    if (index < 0 || index >= panelCount || !pending[index]) return;
+    noteCommit();
+    pending[index] = false;
+    panels[index]->endFrame();
+}
+
+void PanelGroup::commitAll() {
+    for (int i = 0; i < panelCount; i++) {
+        commit(i);
+    }
+}
+
+void PanelGroup::showFrame(int index, const uint8_t* image) {
+    if (index < 0 || index >= panelCount) return;
+    noteCommit();
+    panels[index]->showFrame(image);
+}
+
+bool PanelGroup::isRefreshing() const {
+    for (int i = 0; i < panelCount; i++) {
+        if (panels[i]->isRefreshing()) return true;
+    }
+    return false;
+}
+
+bool PanelGroup::waitAll(unsigned long timeoutMs) {
+    unsigned long start = millis();
+    bool idle = true;
+    for (int i = 0; i < panelCount; i++) {
+        unsigned long elapsed = millis() - start;
+        idle = panels[i]->waitForRefresh(elapsed < timeoutMs ? timeoutMs - elapsed : 0) && idle;
+    }
+    if (idle) {
+        Serial.printf("Panel group refreshed in %lu ms\n", millis() - commitStart);
+    }
+    return idle;
+}
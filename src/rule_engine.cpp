@@ -0,0 +1,358 @@
+#include <Arduino.h>
+#include "../include/rule_engine.h"
+#include "../include/memory_report.h"
+
+static const char* const SIGNAL_NAMES[] = {"temperature", "humidity", "wave", "rating"};
+static_assert(sizeof(SIGNAL_NAMES) / sizeof(SIGNAL_NAMES[0]) == (size_t)RuleSignal::COUNT,
+              "every RuleSignal needs a name");
+
+// Same scale as ForecastParser::getRating
+static const char* const RATING_NAMES[] = {"FLAT", "SMALL", "GOOD", "GREAT", "EPIC", "HUGE"};
+static const int RATING_COUNT = sizeof(RATING_NAMES) / sizeof(RATING_NAMES[0]);
+
+static const int MAX_WORDS = 5;
+
+static bool parseValue(RuleSignal signal, const char* word, float& value) {
+    if (signal == RuleSignal::SURF_RATING) {
+        int level = RuleEngine::ratingLevel(word);
+        if (level >= 0) {
+            value = level;
+            return true;
+        }
+    }
+    char* end = nullptr;
+    value = strtof(word, &end);
+    return end != word && *end == '\0' && !isnan(value);
+}
+
+// "90s", "15m", "2h"
+static bool parseDuration(const char* word, uint32_t& durationMs) {
+    char* end = nullptr;
+    unsigned long amount = strtoul(word, &end, 10);
+    uint64_t unitMs = 0;
+    if (end != word && end[0] != '\0' && end[1] == '\0') {
+        if (*end == 's') unitMs = 1000;
+        else if (*end == 'm') unitMs = 60000;
+        else if (*end == 'h') unitMs = 3600000;
+    }
+    // millis() differences wrap after ~49 days
+    uint64_t total = (uint64_t)amount * unitMs;
+    if (total == 0 || total > 0x7FFFFFFFu) return false;
+    durationMs = (uint32_t)total;
+    return true;
+}
+
+RuleEngine::RuleEngine()
+    : ruleCount(0), states(nullptr), keyCount(0), handler(nullptr),
+      samples(0), totalUs(0), maxUs(0), alertsRaised(0) {
+}
+
+RuleEngine::~RuleEngine() {
+    MemoryReport::release(states);
+}
+
+bool RuleEngine::parse(const char* text, CompiledRule& rule, const char** error) {
+    char line[RULE_TEXT_LENGTH];
+    if (strlcpy(line, text, sizeof(line)) >= sizeof(line)) {
+        *error = "too long";
+        return false;
+    }
+
+    char* actions = strstr(line, "=>");
+    if (!actions) {
+        *error = "no '=>' followed by actions";
+        return false;
+    }
+    *actions = '\0';
+    actions += 2;
+
+    char* words[MAX_WORDS + 1];
+    int count = 0;
+    char* save = nullptr;
+    for (char* word = strtok_r(line, " \t", &save); word; word = strtok_r(nullptr, " \t", &save)) {
+        if (count > MAX_WORDS) break;
+        words[count++] = word;
+    }
+
+    int signal = 0;
+    while (signal < (int)RuleSignal::COUNT && (count == 0 || strcmp(words[0], SIGNAL_NAMES[signal]) != 0)) {
+        signal++;
+    }
+    if (signal == (int)RuleSignal::COUNT) {
+        *error = "unknown signal (temperature, humidity, wave, rating)";
+        return false;
+    }
+    rule.text = text;
+    rule.signal = (RuleSignal)signal;
+    rule.from = NAN;
+    rule.windowMs = 0;
+
+    if (count == 4 && strcmp(words[2], "->") == 0) {
+        rule.kind = RuleKind::CHANGES_TO;
+        if (!parseValue(rule.signal, words[1], rule.from) || !parseValue(rule.signal, words[3], rule.threshold)) {
+            *error = "bad value";
+            return false;
+        }
+        if (rule.threshold <= rule.from) {
+            *error = "a change must go up, e.g. SMALL -> GREAT";
+            return false;
+        }
+    } else if (count == 5) {
+        const char* keyword;
+        if (strcmp(words[1], ">") == 0) {
+            rule.kind = RuleKind::ABOVE_FOR;
+            keyword = "for";
+        } else if (strcmp(words[1], "<") == 0) {
+            rule.kind = RuleKind::BELOW_FOR;
+            keyword = "for";
+        } else if (strcmp(words[1], "rises") == 0) {
+            rule.kind = RuleKind::RISES_WITHIN;
+            keyword = "within";
+        } else if (strcmp(words[1], "falls") == 0) {
+            rule.kind = RuleKind::FALLS_WITHIN;
+            keyword = "within";
+        } else {
+            *error = "unknown operator (>, <, rises, falls, ->)";
+            return false;
+        }
+        if (!parseValue(rule.signal, words[2], rule.threshold)) {
+            *error = "bad value";
+            return false;
+        }
+        if (strcmp(words[3], keyword) != 0 || !parseDuration(words[4], rule.windowMs)) {
+            *error = rule.kind == RuleKind::ABOVE_FOR || rule.kind == RuleKind::BELOW_FOR
+                ? "expected 'for <n>s|m|h'" : "expected 'within <n>s|m|h'";
+            return false;
+        }
+        if ((rule.kind == RuleKind::RISES_WITHIN || rule.kind == RuleKind::FALLS_WITHIN) && rule.threshold <= 0) {
+            *error = "rise/fall amount must be positive";
+            return false;
+        }
+    } else {
+        *error = "expected '<signal> >|< <value> for <time>', '<signal> rises|falls <amount> within <time>' "
+                 "or '<signal> <from> -> <to>'";
+        return false;
+    }
+
+    rule.actions = 0;
+    for (char* word = strtok_r(actions, " \t,", &save); word; word = strtok_r(nullptr, " \t,", &save)) {
+        if (strcmp(word, "led") == 0) rule.actions |= RULE_ACTION_LED;
+        else if (strcmp(word, "display") == 0) rule.actions |= RULE_ACTION_DISPLAY;
+        else if (strcmp(word, "hook") == 0) rule.actions |= RULE_ACTION_HOOK;
+        else {
+            *error = "unknown action (led, display, hook)";
+            return false;
+        }
+    }
+    if (rule.actions == 0) {
+        *error = "no actions after '=>'";
+        return false;
+    }
+    return true;
+}
+
+bool RuleEngine::compile(const char* const* texts, int count, int keys) {
+    MemoryReport::release(states);
+    states = nullptr;
+    ruleCount = 0;
+    keyCount = keys < 1 ? 1 : (keys > RULE_MAX_KEYS ? RULE_MAX_KEYS : keys);
+
+    bool allCompiled = true;
+    for (int i = 0; i < count; i++) {
+        const char* error = nullptr;
+        if (ruleCount == RULE_MAX_RULES) {
+            Serial.printf("Rule %d skipped (more than %d rules): %s\n", i + 1, RULE_MAX_RULES, texts[i]);
+            allCompiled = false;
+        } else if (parse(texts[i], rules[ruleCount], &error)) {
+            ruleCount++;
+        } else {
+            Serial.printf("Rule %d rejected (%s): %s\n", i + 1, error, texts[i]);
+            allCompiled = false;
+        }
+    }
+    if (ruleCount == 0) return allCompiled;
+
+    size_t stateBytes = ruleCount * keyCount * sizeof(RuleState);
+    states = (RuleState*)MemoryReport::allocate("rules", "rule state", stateBytes, MemoryPlacement::INTERNAL);
+    if (!states) {
+        Serial.println("Out of memory for rule state - rules disabled");
+        ruleCount = 0;
+        return false;
+    }
+    reset();
+
+    Serial.printf("Compiled %d rules (%u bytes) with %u bytes of state for %d keys\n",
+                  ruleCount, (unsigned)(ruleCount * sizeof(CompiledRule)), (unsigned)stateBytes, keyCount);
+    return allCompiled;
+}
+
+void RuleEngine::setHandler(RuleHandler newHandler) {
+    handler = newHandler;
+}
+
+void RuleEngine::resetState(RuleState& state) {
+    state.since = 0;
+    for (int i = 0; i < RULE_WINDOW_BUCKETS; i++) {
+        state.lowest[i] = INFINITY;
+    }
+    state.bucket = 0;
+    state.holding = false;
+    state.active = false;
+}
+
+void RuleEngine::reset() {
+    if (!states) return;
+    for (int i = 0; i < ruleCount * keyCount; i++) {
+        resetState(states[i]);
+    }
+}
+
+// Advances one rule's state by a sample; returns whether the alert should be active
+bool RuleEngine::step(const CompiledRule& rule, RuleState& state, float value, unsigned long now) {
+    switch (rule.kind) {
+        case RuleKind::ABOVE_FOR:
+        case RuleKind::BELOW_FOR: {
+            bool condition = rule.kind == RuleKind::ABOVE_FOR ? value > rule.threshold : value < rule.threshold;
+            if (!condition) {
+                state.holding = false;
+                return false;
+            }
+            if (!state.holding) {
+                state.holding = true;
+                state.since = now;
+            }
+            return now - state.since >= rule.windowMs;
+        }
+
+        case RuleKind::RISES_WITHIN:
+        case RuleKind::FALLS_WITHIN: {
+            // A fall is a rise of the negated value, so one minimum serves both
+            float x = rule.kind == RuleKind::RISES_WITHIN ? value : -value;
+            // The oldest bucket is kept whole, so the window reaches back at least windowMs
+            unsigned long span = rule.windowMs / (RULE_WINDOW_BUCKETS - 1);
+            if (span == 0) span = 1;
+
+            // Retire the buckets that slid out of the window; at most all of them
+            unsigned long elapsed = now - state.since;
+            if (!state.holding || elapsed >= span * RULE_WINDOW_BUCKETS) {
+                for (int i = 0; i < RULE_WINDOW_BUCKETS; i++) {
+                    state.lowest[i] = INFINITY;
+                }
+                state.bucket = 0;
+                state.since = now;
+                state.holding = true;
+            } else {
+                for (unsigned long i = elapsed / span; i > 0; i--) {
+                    state.bucket = (state.bucket + 1) % RULE_WINDOW_BUCKETS;
+                    state.lowest[state.bucket] = INFINITY;
+                    state.since += span;
+                }
+            }
+
+            float baseline = INFINITY;
+            for (int i = 0; i < RULE_WINDOW_BUCKETS; i++) {
+                if (state.lowest[i] < baseline) baseline = state.lowest[i];
+            }
+            if (x < state.lowest[state.bucket]) state.lowest[state.bucket] = x;
+            
+            // Half the amount clears it again, so a steady climb does not flap as buckets retire
+            float rise = x - baseline;
+            return rise >= (state.active ? rule.threshold / 2 : rule.threshold);
+        }
+
+        case RuleKind::CHANGES_TO: {
+            // Armed by a value at or below "from", so a climb over several samples counts;
+            // the alert then stays raised while the value holds at the target level
+            if (value <= rule.from) state.holding = true;
+            if (state.active) return value >= rule.threshold;
+            if (!state.holding || value < rule.threshold) return false;
+            state.holding = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RuleEngine::evaluate(int key, const char* label, const RuleSample& sample, unsigned long now) {
+    if (!states || key < 0 || key >= keyCount) return;
+
+    RuleEvent events[RULE_MAX_RULES];
+    int eventCount = 0;
+    int checked = 0;
+
+    unsigned long start = micros();
+    for (int i = 0; i < ruleCount; i++) {
+        const CompiledRule& rule = rules[i];
+        float value = sample.values[(int)rule.signal];
+        if (isnan(value)) continue;
+        checked++;
+
+        RuleState& state = states[i * keyCount + key];
+        bool active = step(rule, state, value, now);
+        if (active != state.active) {
+            state.active = active;
+            events[eventCount++] = {i, &rule, (uint8_t)key, label, value, active};
+        }
+    }
+    unsigned long elapsed = micros() - start;
+    if (checked == 0) return;
+
+    samples++;
+    totalUs += elapsed;
+    if (elapsed > maxUs) maxUs = elapsed;
+    Serial.printf("Rules: %d checked for %s in %lu us (avg %lu us over %lu samples)\n",
+                  checked, label, elapsed, totalUs / samples, samples);
+
+    // Handlers may refresh the panel or queue telemetry; not part of the evaluation cost
+    for (int i = 0; i < eventCount; i++) {
+        const RuleEvent& event = events[i];
+        if (event.active) alertsRaised++;
+        Serial.printf("Alert %s for %s: %s (%s %.1f)\n", event.active ? "RAISED" : "cleared", label,
+                      event.compiled->text, getSignalName(event.compiled->signal), event.value);
+        if (handler) handler(event);
+    }
+}
+
+int RuleEngine::getRuleCount() const {
+    return ruleCount;
+}
+
+bool RuleEngine::isAlertActive(uint8_t actions) const {
+    if (!states) return false;
+    for (int i = 0; i < ruleCount; i++) {
+        if (!(rules[i].actions & actions)) continue;
+        for (int key = 0; key < keyCount; key++) {
+            if (states[i * keyCount + key].active) return true;
+        }
+    }
+    return false;
+}
+
+void RuleEngine::printStats() const {
+    Serial.printf("Rule engine: %d rules (%u bytes + %u bytes state), %lu samples, avg %lu us, max %lu us, %lu alerts raised\n",
+                  ruleCount, (unsigned)(ruleCount * sizeof(CompiledRule)),
+                  (unsigned)(states ? ruleCount * keyCount * sizeof(RuleState) : 0), samples,
+                  samples > 0 ? totalUs / samples : 0, maxUs, alertsRaised);
+    for (int i = 0; i < ruleCount; i++) {
+        int active = 0;
+        for (int key = 0; key < keyCount; key++) {
+            if (states[i * keyCount + key].active) active++;
+        }
+        Serial.printf("  %d. %-48s active for %d of %d\n", i + 1, rules[i].text, active, keyCount);
+    }
+}
+
+const char* RuleEngine::getSignalName(RuleSignal signal) {
+    return signal < RuleSignal::COUNT ? SIGNAL_NAMES[(int)signal] : "unknown";
+}
+
+int RuleEngine::ratingLevel(const char* rating) {
+    for (int i = 0; i < RATING_COUNT; i++) {
+        if (strcasecmp(rating, RATING_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char* RuleEngine::getRatingName(int level) {
+    return level >= 0 && level < RATING_COUNT ? RATING_NAMES[level] : "?";
+}
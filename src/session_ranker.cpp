@@ -0,0 +1,105 @@
+#include <math.h>
+#include <time.h>
+#include "../include/session_ranker.h"
+
+static const int64_t SECONDS_PER_HOUR = 3600;
+
+// Earlier wins a tie, so equally good sessions come in the order they happen
+static bool better(const Session& a, const Session& b) {
+    return a.score > b.score || (a.score == b.score && a.time < b.time);
+}
+
+SessionRanker::SessionRanker() : lastScoredHours(0) {
+    criteria = {0.6f, 1.8f, 0.6f, 7, 19}; // Roughly 2-6 ft, daytime
+    for (int i = 0; i < SESSION_MAX_LOCATIONS; i++) {
+        candidateCount[i] = 0;
+    }
+}
+
+void SessionRanker::setCriteria(const SessionCriteria& newCriteria) {
+    criteria = newCriteria;
+    for (int i = 0; i < SESSION_MAX_LOCATIONS; i++) {
+        candidateCount[i] = 0;
+    }
+}
+
+float SessionRanker::scoreHour(float height, int64_t time) const {
+    if (isnan(height)) return 0;
+
+    time_t seconds = (time_t)time;
+    struct tm local;
+    localtime_r(&seconds, &local);
+    if (local.tm_hour < criteria.daylightStartHour || local.tm_hour >= criteria.daylightEndHour) return 0;
+
+    float distance = 0;
+    if (height < criteria.idealMinHeight) {
+        distance = criteria.idealMinHeight - height;
+    } else if (height > criteria.idealMaxHeight) {
+        distance = height - criteria.idealMaxHeight;
+    }
+    if (distance >= criteria.heightTolerance) return 0;
+    return 100.0f * (1.0f - distance / criteria.heightTolerance);
+}
+
+void SessionRanker::update(int location, const float* heights, int count, int64_t startTime, int64_t now) {
+    if (location < 0 || location >= SESSION_MAX_LOCATIONS) return;
+
+    // Without a start time there is no daylight or "upcoming" to judge by
+    candidateCount[location] = 0;
+    lastScoredHours = 0;
+    if (startTime == 0) return;
+
+    if (count > SESSION_MAX_HOURS) count = SESSION_MAX_HOURS;
+    float scores[SESSION_MAX_HOURS];
+    for (int i = 0; i < count; i++) {
+        int64_t time = startTime + i * SECONDS_PER_HOUR;
+        bool ended = time + SECONDS_PER_HOUR <= now;
+        scores[i] = ended ? 0 : scoreHour(heights[i], time);
+    }
+    lastScoredHours = count;
+
+    // Greedy pick of the best hours, keeping picks from this spot apart so
+    // one long swell does not fill the whole list
+    Session* picks = candidates[location];
+    int& picked = candidateCount[location];
+    while (picked < SESSION_TOP_K) {
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            if (scores[i] <= 0 || (best >= 0 && scores[i] <= scores[best])) continue;
+            best = i;
+        }
+        if (best < 0) break;
+
+        picks[picked++] = {location, startTime + best * SECONDS_PER_HOUR, heights[best], scores[best]};
+        int from = best - (SESSION_MIN_GAP_HOURS - 1);
+        int to = best + (SESSION_MIN_GAP_HOURS - 1);
+        for (int i = from < 0 ? 0 : from; i <= to && i < count; i++) {
+            scores[i] = 0;
+        }
+    }
+}
+
+void SessionRanker::clear(int location) {
+    if (location >= 0 && location < SESSION_MAX_LOCATIONS) {
+        candidateCount[location] = 0;
+    }
+}
+
+int SessionRanker::getTopSessions(Session* out, int k, int64_t now) const {
+    // Merge the per-location lists with an insertion sort into out
+    int found = 0;
+    for (int location = 0; location < SESSION_MAX_LOCATIONS; location++) {
+        for (int i = 0; i < candidateCount[location]; i++) {
+            const Session& candidate = candidates[location][i];
+            if (candidate.time + SECONDS_PER_HOUR <= now) continue;
+
+            int slot = found < k ? found++ : k;
+            while (slot > 0 && better(candidate, out[slot - 1])) {
+                if (slot < k) out[slot] = out[slot - 1];
+                slot--;
+            }
+            if (slot < k) out[slot] = candidate;
+        }
+    }
+    return found;
+}
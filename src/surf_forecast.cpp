@@ -1,27 +1,48 @@
 #include <Arduino.h>
 #include "../include/surf_forecast.h"
 #include "../include/time_utils.h"
+#include "../include/energy_monitor.h"
+#include "../include/memory_report.h"
+#include "../include/inflate_stream.h"
+#include "../include/boot_snapshot.h"
+#include <esp_heap_caps.h>
 
-// Define surf locations array
-static const SurfLocation surfLocations[] = {
-    {50.425998, -5.103096, "Cribbar, Newquay"},
-    {50.079780, -5.698678, "Sennen Cove"},
-    {50.229620, -5.394250, "Gwithian"},
-    {50.445738, -5.045831, "Watergate Bay"},
-    {50.042637, -5.649877, "Porthcurno"},
-    {51.115862, -4.227910, "Saunton Sands"},
-    {51.130414, -4.238428, "Croyde Bay"}
+// Keeps parsed JSON documents out of internal RAM
+class PsramJsonAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override { return heap_caps_malloc(size, caps()); }
+    void deallocate(void* pointer) override { heap_caps_free(pointer); }
+    void* reallocate(void* pointer, size_t newSize) override { return heap_caps_realloc(pointer, newSize, caps()); }
+
+private:
+    static uint32_t caps() { return psramFound() ? MALLOC_CAP_SPIRAM : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT); }
 };
 
-const SurfLocation* SurfForecast::getSurfLocations() {
-    return surfLocations;
-}
+static PsramJsonAllocator psramJsonAllocator;
 
-int SurfForecast::getNumLocations() {
-    return sizeof(surfLocations) / sizeof(surfLocations[0]);
+SurfForecast::SurfForecast(EPaperDisplay* displayPtr)
+    : display(displayPtr), fetchPolicy("Surf fetch"), polling("Surf polling", REFRESH_INTERVAL_MS, REFRESH_INTERVAL_MS, FORECAST_MAX_AGE_MS) {
+    for (int i = 0; i < MAX_CAROUSEL_FRAMES; i++) {
+        referenceWaveHeight[i] = NAN;
+    }
+    
+    // Until a position is chosen, rotate through the catalog from the start
+    // (the built-in spots, as the partition is not mapped yet)
+    rotationCount = catalog.size() < (uint32_t)MAX_CAROUSEL_FRAMES ? catalog.size() : MAX_CAROUSEL_FRAMES;
+    for (int i = 0; i < rotationCount; i++) {
+        rotation[i] = i;
+    }
+    
+    const float FEET_PER_METER = 3.28084f;
+    ranker.setCriteria({SESSION_IDEAL_MIN_FT / FEET_PER_METER, SESSION_IDEAL_MAX_FT / FEET_PER_METER,
+                        SESSION_HEIGHT_TOLERANCE_FT / FEET_PER_METER,
+                        SESSION_DAYLIGHT_START_HOUR, SESSION_DAYLIGHT_END_HOUR});
 }
 
-SurfForecast::SurfForecast(EPaperDisplay* displayPtr) : display(displayPtr) {
+SurfForecast::~SurfForecast() {
+    for (int i = 0; i < MAX_CAROUSEL_FRAMES; i++) {
+        MemoryReport::release(locationFrames[i]);
+    }
 }
 
 void SurfForecast::begin(const char* ssid, const char* password) {
@@ -42,30 +63,13 @@ void SurfForecast::begin(const char* ssid, const char* password) {
         Serial.println();
         Serial.printf("WiFi connected! IP: %s\n", WiFi.localIP().toString().c_str());
         
-        // Initialize NTP time sync
-        TimeUtils::begin();
-        
-        Serial.println("Waiting for NTP time sync...");
-        struct tm timeinfo;
-        int attempts = 0;
-        while (!getLocalTime(&timeinfo) && attempts < 10) {
-            delay(1000);
-            attempts++;
-            Serial.print(".");
-        }
-        
-        if (attempts < 10) {
-            Serial.println();
-            Serial.printf("Time synchronized: %02d:%02d:%02d\n", 
-                         timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        } else {
-            Serial.println();
-            Serial.println("Failed to sync time with NTP");
-        }
-        
-        // Fetch initial data
-        if (fetchForecastData()) {
+        // Fetch initial data - its Date header seeds the clock while SNTP syncs in the background.
+        // A restored snapshot young enough for the polling interval is used as is.
+        if (isLocationFresh(currentLocationIndex, millis())) {
+            Serial.println("Restored forecast is recent - skipping the initial fetch");
+        } else if (attemptFetch()) {
             Serial.println("Initial surf data fetched successfully!");
+            recordPollingSample(currentLocationIndex);
         } else {
             Serial.println("Failed to fetch initial surf data");
         }
@@ -81,70 +85,103 @@ bool SurfForecast::fetchForecastData() {
         return false;
     }
     
+    // Cleared again only once the new data has been parsed
+    lastFetchFailed = true;
+    
     // Get current location
-    const SurfLocation* locations = getSurfLocations();
-    const SurfLocation& currentLocation = locations[currentLocationIndex];
+    SurfLocation currentLocation = getLocation(currentLocationIndex);
+    
+    bool flatBuffers = format == ForecastFormat::FLATBUFFERS;
+    if (format == ForecastFormat::COMPARE) {
+        flatBuffers = compareFlatBuffers;
+        compareFlatBuffers = !compareFlatBuffers;
+    }
     
     HTTPClient http;
-    String url = API_URL + "?latitude=" + String(currentLocation.latitude) + 
+    String url = apiUrl + "?latitude=" + String(currentLocation.latitude) + 
                 "&longitude=" + String(currentLocation.longitude) + 
-                "&hourly=wave_height";
+                "&hourly=wave_height&timeformat=unixtime";
+    if (flatBuffers) {
+        url += "&format=flatbuffers";
+    }
     
     Serial.printf("Fetching: %s\n", url.c_str());
     http.begin(url);
+    http.setConnectTimeout(FETCH_CONNECT_TIMEOUT_MS);
+    http.setTimeout(FETCH_READ_TIMEOUT_MS);
+    
+    // Date seeds the clock if SNTP has not synced yet; Content-Encoding tells us if the body is gzip
+    const char* headerKeys[] = {"Date", "Content-Encoding"};
+    http.collectHeaders(headerKeys, 2);
+    
+    // A gzip body is several times smaller, so the radio is on for less time.
+    // HTTP/1.0 avoids chunked encoding so it can be inflated straight off the connection.
+    http.useHTTP10(true);
+    http.addHeader("Accept-Encoding", "gzip");
+    
+    int httpCode;
+    bool parsed = false;
+    ForecastSummary summary;
+    ForecastSeries series = {hourlyHeights, SESSION_MAX_HOURS, 0, 0};
+    const char* error = nullptr;
+    {
+        // Radio is transmitting/receiving for the whole request-response exchange,
+        // which includes parsing since the body is consumed as it arrives
+        EnergyScope radio(PowerState::RADIO_TRANSMITTING);
+        httpCode = http.GET();
+        if (httpCode > 0) {
+            TimeUtils::seedFromHttpDate(http.header("Date"));
+        }
+        if (httpCode == HTTP_CODE_OK) {
+            parsed = parseResponse(http, flatBuffers, summary, series, &error);
+        }
+    }
     
-    int httpCode = http.GET();
     if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        
-        // Parse JSON response
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
-        
-        if (error) {
-            Serial.printf("JSON parsing error: %s\n", error.c_str());
+        if (!parsed) {
+            Serial.printf("Forecast parsing error: %s\n", error);
             http.end();
             return false;
         }
-        
-        // Extract wave height data
-        JsonArray times = doc["hourly"]["time"];
-        JsonArray waveHeights = doc["hourly"]["wave_height"];
-        
-        if (times.size() == 0 || waveHeights.size() == 0) {
-            Serial.println("No wave data received");
-            http.end();
-            return false;
+        if (summary.nullHours > 0) {
+            Serial.printf("Skipped %d of %d null wave heights\n", summary.nullHours, summary.hours);
         }
         
-        // Get current conditions (first data point)
-        conditions.currentWaveHeight = metersToFeet(waveHeights[0].as<float>());
-        conditions.currentRating = getRatingFromHeight(waveHeights[0].as<float>());
-        
-        // Calculate today's average (next 12 hours)
-        float todayAvg = calculateAverage(waveHeights, 1, 12);
-        conditions.todayAverage = metersToFeet(todayAvg);
-        conditions.todayRating = getRatingFromHeight(todayAvg);
-        
-        // Calculate tomorrow's average (hours 24-36)
-        float tomorrowAvg = calculateAverage(waveHeights, 24, 36);
-        conditions.tomorrowAverage = metersToFeet(tomorrowAvg);
-        conditions.tomorrowRating = getRatingFromHeight(tomorrowAvg);
-        
         // Store the timestamp when data was fetched
         lastFetchTime = TimeUtils::getCurrentTimestamp();
-        
-        // Set time and location (use current location)
-        conditions.currentTime = lastFetchTime;
-        const SurfLocation* locations = getSurfLocations();
-        conditions.location = locations[currentLocationIndex].name;
+        applySummary(summary, lastFetchTime);
         
         Serial.printf("Data parsed - Current: %.1fft (%s), Today: %.1fft (%s), Tomorrow: %.1fft (%s)\n",
                      conditions.currentWaveHeight, conditions.currentRating.c_str(),
                      conditions.todayAverage, conditions.todayRating.c_str(),
                      conditions.tomorrowAverage, conditions.tomorrowRating.c_str());
         
+        if (telemetry) {
+            telemetry->record("surf", conditions.location.c_str(),
+                              "wave_height_ft", conditions.currentWaveHeight,
+                              "today_ft", conditions.todayAverage,
+                              "tomorrow_ft", conditions.tomorrowAverage);
+        }
+        
+        if (rules) {
+            RuleSample sample;
+            sample.set(RuleSignal::WAVE_HEIGHT, conditions.currentWaveHeight);
+            sample.set(RuleSignal::SURF_RATING, RuleEngine::ratingLevel(conditions.currentRating.c_str()));
+            rules->evaluate(currentLocationIndex, conditions.location.c_str(), sample, millis());
+        }
+        
         http.end();
+        
+        lastFetchFailed = false;
+        lastSuccessfulFetch = millis();
+        if (currentLocationIndex < MAX_CAROUSEL_FRAMES) {
+            locationFetchTime[currentLocationIndex] = lastSuccessfulFetch;
+        }
+        
+        // Data for this spot changed - render its carousel frame and rescore its hours now
+        prerenderLocationFrame(currentLocationIndex);
+        rankSessions(currentLocationIndex, series);
+        saveSnapshot(currentLocationIndex, summary);
         return true;
     } else {
         Serial.printf("HTTP error: %d\n", httpCode);
@@ -153,174 +190,497 @@ bool SurfForecast::fetchForecastData() {
     }
 }
 
-void SurfForecast::displayCurrentConditions() {
-    if (!display) return;
+void SurfForecast::applySummary(const ForecastSummary& summary, const String& fetchTime) {
+    // Current conditions from the first forecast point
+    conditions.currentWaveHeight = metersToFeet(summary.currentHeight);
+    conditions.currentRating = getRatingFromHeight(summary.currentHeight);
     
-    Serial.println("Displaying surf forecast on e-paper...");
+    // Today's average (next 12 hours)
+    conditions.todayAverage = metersToFeet(summary.todayAverage);
+    conditions.todayRating = getRatingFromHeight(summary.todayAverage);
     
-    // Get direct access to the GxEPD2 display for proper paged drawing
-    auto* gxDisplay = display->getDisplay();
-    gxDisplay->setRotation(1); // Landscape orientation
-    gxDisplay->setFullWindow();
-    gxDisplay->firstPage();
-    
-    do {
-        // Clear the screen
-        gxDisplay->fillScreen(GxEPD_WHITE);
-        gxDisplay->setTextColor(GxEPD_BLACK);
-        gxDisplay->setFont();
-        
-        // Header - smaller and more compact (296x128 display)
-        String headerText = "SURF FORECAST @ " + conditions.location;
-        gxDisplay->setTextSize(1);
-        gxDisplay->setCursor(2, 6);
-        gxDisplay->print(headerText);
-        
-        // Draw horizontal line under header
-        gxDisplay->drawLine(2, 20, 294, 20, GxEPD_BLACK);
-        
-        // Column centerlines as specified
-        int col1Center = 48;   // Column 1 centerline
-        int col2Center = 148;  // Column 2 centerline  
-        int col3Center = 244;  // Column 3 centerline
-        int colY = 40;         // Start Y position for column content
-        
-        // Draw vertical separators between columns
-        gxDisplay->drawLine(98, 20, 98, 108, GxEPD_BLACK);   // Between col 1 & 2
-        gxDisplay->drawLine(196, 20, 196, 108, GxEPD_BLACK); // Between col 2 & 3
-        
-        // Column 1 - NOW
-        gxDisplay->setTextSize(1);
-        int nowWidth = display->getTextWidth("NOW", 1);
-        gxDisplay->setCursor(col1Center - nowWidth/2, colY);
-        gxDisplay->print("NOW");
-        
-        String wave1 = String(conditions.currentWaveHeight, 1);
-        int wave1Width = display->getTextWidth(wave1.c_str(), 2);
-        gxDisplay->setTextSize(2);
-        gxDisplay->setCursor(col1Center - wave1Width/2, colY + 15);
-        gxDisplay->print(wave1);
-        gxDisplay->setTextSize(1);
-        gxDisplay->setCursor(col1Center + wave1Width/2 + 2, colY + 15);
-        gxDisplay->print("ft");
-        
-        int rating1Width = display->getTextWidth(conditions.currentRating.c_str(), 1);
-        gxDisplay->setCursor(col1Center - rating1Width/2, colY + 35);
-        gxDisplay->print(conditions.currentRating);
-        
-        // Column 2 - TODAY
-        int todayWidth = display->getTextWidth("TODAY", 1);
-        gxDisplay->setCursor(col2Center - todayWidth/2, colY);
-        gxDisplay->print("TODAY");
-        
-        String wave2 = String(conditions.todayAverage, 1);
-        int wave2Width = display->getTextWidth(wave2.c_str(), 2);
-        gxDisplay->setTextSize(2);
-        gxDisplay->setCursor(col2Center - wave2Width/2, colY + 15);
-        gxDisplay->print(wave2);
-        gxDisplay->setTextSize(1);
-        gxDisplay->setCursor(col2Center + wave2Width/2 + 2, colY + 15);
-        gxDisplay->print("ft");
-        
-        int rating2Width = display->getTextWidth(conditions.todayRating.c_str(), 1);
-        gxDisplay->setCursor(col2Center - rating2Width/2, colY + 35);
-        gxDisplay->print(conditions.todayRating);
-        
-        // Column 3 - TOMORROW
-        int tomorrowWidth = display->getTextWidth("TOMORROW", 1);
-        gxDisplay->setCursor(col3Center - tomorrowWidth/2, colY);
-        gxDisplay->print("TOMORROW");
-        
-        String wave3 = String(conditions.tomorrowAverage, 1);
-        int wave3Width = display->getTextWidth(wave3.c_str(), 2);
-        gxDisplay->setTextSize(2);
-        gxDisplay->setCursor(col3Center - wave3Width/2, colY + 15);
-        gxDisplay->print(wave3);
-        gxDisplay->setTextSize(1);
-        gxDisplay->setCursor(col3Center + wave3Width/2 + 2, colY + 15);
-        gxDisplay->print("ft");
-        
-        int rating3Width = display->getTextWidth(conditions.tomorrowRating.c_str(), 1);
-        gxDisplay->setCursor(col3Center - rating3Width/2, colY + 35);
-        gxDisplay->print(conditions.tomorrowRating);
+    // Tomorrow's average (hours 24-36)
+    conditions.tomorrowAverage = metersToFeet(summary.tomorrowAverage);
+    conditions.tomorrowRating = getRatingFromHeight(summary.tomorrowAverage);
+    
+    // Set time and location (use current location)
+    conditions.currentTime = fetchTime;
+    conditions.location = getLocation(currentLocationIndex).name;
+}
+
+void SurfForecast::saveSnapshot(int index, const ForecastSummary& summary) {
+    SurfLocation location = getLocation(index);
+    SpotSnapshot snapshot = {};
+    snapshot.summary = summary;
+    snapshot.latitude = location.latitude;
+    snapshot.longitude = location.longitude;
+    snapshot.fetchedAt = TimeUtils::isTimeSynced() ? time(nullptr) : 0;
+    strlcpy(snapshot.fetchTime, lastFetchTime.c_str(), sizeof(snapshot.fetchTime));
+    
+    char key[16];
+    snprintf(key, sizeof(key), "surf%d", index);
+    BootSnapshot::save(key, &snapshot, sizeof(snapshot));
+}
+
+bool SurfForecast::restoreSnapshot() {
+    if (!display) return false;
+    
+    unsigned long now = millis();
+    int restored = 0;
+    int newest = -1;
+    int64_t newestFetch = 0;
+    int64_t youngestAgeMs = FORECAST_STALE_MS;
+    
+    for (int i = 0; i < getNumLocations(); i++) {
+        SpotSnapshot snapshot;
+        char key[16];
+        snprintf(key, sizeof(key), "surf%d", i);
+        if (!BootSnapshot::load(key, &snapshot, sizeof(snapshot))) continue;
+        
+        // Saved for a spot that has since left the rotation
+        SurfLocation location = getLocation(i);
+        if (snapshot.latitude != location.latitude || snapshot.longitude != location.longitude) continue;
+        
+        currentLocationIndex = i;
+        lastFetchTime = snapshot.fetchTime;
+        applySummary(snapshot.summary, lastFetchTime);
+        prerenderLocationFrame(i);
+        referenceWaveHeight[i] = conditions.currentWaveHeight;
+        
+        // Age is only known if the wall clock survived the reset; otherwise treat the
+        // data as stale so it is shown but re-fetched as soon as the spot comes round
+        int64_t ageMs = FORECAST_STALE_MS;
+        if (snapshot.fetchedAt > 0 && TimeUtils::isTimeSynced()) {
+            int64_t age = (int64_t)time(nullptr) - snapshot.fetchedAt;
+            if (age >= 0 && age * 1000 < (int64_t)FORECAST_STALE_MS) ageMs = age * 1000;
+        }
+        locationFetchTime[i] = now - (unsigned long)ageMs;
+        if (ageMs < youngestAgeMs) youngestAgeMs = ageMs;
+        if (newest < 0 || snapshot.fetchedAt > newestFetch) {
+            newest = i;
+            newestFetch = snapshot.fetchedAt;
+        }
+        restored++;
+    }
+    
+    if (restored == 0) {
+        currentLocationIndex = 0;
+        lastFetchTime = "";
+        Serial.println("No surf snapshot saved for these spots");
+        return false;
+    }
+    
+    if (youngestAgeMs < (int64_t)FORECAST_STALE_MS) {
+        lastSuccessfulFetch = now - (unsigned long)youngestAgeMs;
+    }
+    
+    // Carry on from the spot the panel was left showing, if its frame still matches
+    int shown = newest;
+    for (int i = 0; i < getNumLocations(); i++) {
+        if (locationFrameReady[i] &&
+            BootSnapshot::fingerprint(locationFrames[i], FrameBuffer::BUFFER_SIZE) == display->getShownFingerprint()) {
+            shown = i;
+            break;
+        }
+    }
+    
+    SpotSnapshot snapshot;
+    char key[16];
+    snprintf(key, sizeof(key), "surf%d", shown);
+    BootSnapshot::load(key, &snapshot, sizeof(snapshot));
+    currentLocationIndex = shown;
+    lastFetchTime = snapshot.fetchTime;
+    applySummary(snapshot.summary, lastFetchTime);
+    
+    Serial.printf("Restored %d of %d spots from the last snapshot, showing %s\n",
+                  restored, getNumLocations(), conditions.location.c_str());
+    displayCurrentConditions();
+    return true;
+}
+
+bool SurfForecast::parseResponse(HTTPClient& http, bool flatBuffers, ForecastSummary& summary, ForecastSeries& series,
+                                 const char** error) {
+    // Servers may ignore Accept-Encoding; InflateStream then just passes the body through
+    bool gzip = http.header("Content-Encoding").equalsIgnoreCase("gzip");
+    InflateStream body(http.getStream(), gzip);
+    if (!body.begin()) {
+        *error = "not enough memory to inflate the response";
+        return false;
+    }
+    
+    // Parse and aggregate, recording what the ingest cost
+    const char* formatName = flatBuffers ? "flatbuffers" : "json";
+    CountingAllocator allocator(&psramJsonAllocator);
+    uint32_t heapBefore = ESP.getFreeHeap();
+    unsigned long start = micros();
+    
+    if (!flatBuffers && format != ForecastFormat::COMPARE) {
+        bool parsed = ForecastParser::parseStream(body, summary, error, &allocator, 0, &series);
+        unsigned long elapsedUs = micros() - start;
         
-        // Draw horizontal line above footer
-        gxDisplay->drawLine(2, 108, 294, 108, GxEPD_BLACK);
+        if (!parsed && body.hasError()) {
+            *error = "corrupt or truncated gzip body";
+        }
         
-        // Footer - show last updated time
-        String updateText = "Last updated: " + getCurrentTimeString();
-        gxDisplay->setCursor(2, 114);
-        gxDisplay->print(updateText);
+        // The time includes the download, since parsing runs as the body arrives
+        Serial.printf("Received %u bytes (%s) -> %u bytes JSON in %lu us (%.2f MB/s), %u allocations, peak %u bytes, free heap %u -> %u\n",
+                     body.getCompressedBytes(), gzip ? "gzip" : "identity", body.getInflatedBytes(), elapsedUs,
+                     elapsedUs > 0 ? (float)body.getInflatedBytes() / elapsedUs : 0.0f,
+                     allocator.getAllocationCount(), allocator.getPeakBytes(), heapBefore, ESP.getFreeHeap());
+        return parsed;
+    }
+    
+    // Buffer the whole body so the parse can be timed on its own. FlatBuffers
+    // needs it anyway: the wave series is read in place from this buffer.
+    size_t length = 0;
+    size_t capacity = 0;
+    uint8_t* buffer = readBody(body, length, capacity);
+    unsigned long receiveUs = micros() - start;
+    if (!buffer || body.hasError()) {
+        MemoryReport::release(buffer);
+        *error = body.hasError() ? "corrupt or truncated gzip body" : "response too large for the receive buffer";
+        return false;
+    }
+    
+    start = micros();
+    bool parsed = flatBuffers ? ForecastParser::parseFlatBuffer(buffer, length, summary, error, 0, &series)
+                              : ForecastParser::parse((const char*)buffer, length, summary, error, &allocator, 0, &series);
+    unsigned long parseUs = micros() - start;
+    MemoryReport::release(buffer);
+    
+    // Peak is what the ingest held at once: the receive buffer plus any document
+    size_t peakBytes = capacity + allocator.getPeakBytes();
+    Serial.printf("Ingest %s: received %u bytes (%s) -> %u bytes in %lu us; parse %lu us (%.2f MB/s), %u allocations, peak %u bytes (buffer %u + document %u)\n",
+                 formatName, body.getCompressedBytes(), gzip ? "gzip" : "identity", length, receiveUs, parseUs,
+                 parseUs > 0 ? (float)length / parseUs : 0.0f, allocator.getAllocationCount(),
+                 peakBytes, capacity, allocator.getPeakBytes());
+    if (telemetry) {
+        // One series per format, tagged with the spot like "surf" and "fetch"
+        telemetry->record(flatBuffers ? "ingest_flatbuffers" : "ingest_json", getLocation(currentLocationIndex).name,
+                          "parse_us", parseUs,
+                          "peak_bytes", peakBytes,
+                          "body_bytes", length);
+    }
+    return parsed;
+}
+
+uint8_t* SurfForecast::readBody(Stream& body, size_t& length, size_t& capacity) {
+    capacity = FORECAST_BODY_INITIAL_BYTES;
+    length = 0;
+    uint8_t* buffer = (uint8_t*)MemoryReport::allocate("surf", "forecast body", capacity, MemoryPlacement::PSRAM);
+    if (!buffer) return nullptr;
+    
+    while (true) {
+        if (length == capacity) {
+            uint8_t* grown = capacity < FORECAST_BODY_MAX_BYTES
+                ? (uint8_t*)MemoryReport::reallocate(buffer, capacity * 2) : nullptr;
+            if (!grown) {
+                MemoryReport::release(buffer);
+                return nullptr;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
         
-    } while (gxDisplay->nextPage());
+        // A short read means the body ended (or the stream failed)
+        size_t wanted = capacity - length;
+        size_t received = body.readBytes((char*)buffer + length, wanted);
+        length += received;
+        if (received < wanted) break;
+    }
+    return buffer;
+}
+
+void SurfForecast::ensureStaticLayer() {
+    // Rules and column labels never change - rasterize them once
+    if (!display->hasStaticLayer()) {
+        SurfLayout::drawStatic(display->beginStaticLayer());
+        display->endStaticLayer();
+    }
+}
+
+void SurfForecast::prerenderLocationFrame(int index) {
+    if (!display || index >= MAX_CAROUSEL_FRAMES || !psramFound()) return;
+    
+    if (!locationFrames[index]) {
+        locationFrames[index] = (uint8_t*)MemoryReport::allocate("surf", "carousel frame", FrameBuffer::BUFFER_SIZE,
+                                                                 MemoryPlacement::PSRAM);
+        if (!locationFrames[index]) {
+            Serial.println("Out of PSRAM for carousel frames, rendering on demand");
+            return;
+        }
+    }
+    
+    unsigned long start = micros();
+    ensureStaticLayer();
+    FrameBuffer canvas(locationFrames[index]);
+    display->prepareCanvas(canvas, true);
+    SurfLayout::drawConditions(&canvas, conditions);
+    locationFrameReady[index] = true;
+    locationFrameShown[index] = false;
     
-    gxDisplay->hibernate();
+    Serial.printf("Pre-rendered carousel frame %d (%s) in %lu us\n",
+                  index + 1, conditions.location.c_str(), micros() - start);
+}
+
+void SurfForecast::displayCurrentConditions() {
+    if (!display) return;
+    
+    Serial.println("Displaying surf forecast on e-paper...");
+    
+    if (panels && panels->getPanelCount() > 1) {
+        displayOnPanels();
+        return;
+    }
+    
+    // Carousel rotation: push the ready frame for this spot, no rendering needed
+    if (currentLocationIndex < MAX_CAROUSEL_FRAMES && locationFrameReady[currentLocationIndex]) {
+        display->showFrame(locationFrames[currentLocationIndex]);
+        Serial.println("Surf forecast displayed from pre-rendered frame");
+        return;
+    }
+    
+    ensureStaticLayer();
+    Adafruit_GFX* gfx = display->beginFrame(true);
+    SurfLayout::drawConditions(gfx, conditions);
+    display->endFrame();
     Serial.println("Surf forecast displayed with proper 3-column layout!");
 }
 
+void SurfForecast::displayOnPanels() {
+    // One spot per panel, each from its pre-rendered frame. Only spots whose
+    // frame changed are pushed; the group overlaps their refresh waveforms.
+    int pushed = 0;
+    for (int i = 0; i < panels->getPanelCount() && i < getNumLocations(); i++) {
+        if (!locationFrameReady[i] || locationFrameShown[i]) continue;
+        panels->showFrame(i, locationFrames[i]);
+        locationFrameShown[i] = true;
+        pushed++;
+    }
+    Serial.printf("Surf forecast: %d of %d panels updated\n", pushed, panels->getPanelCount());
+    // Block until the overlapped waveforms are done so the group's total
+    // refresh time gets logged; the next fetch is a minute away anyway
+    if (pushed > 1) {
+        panels->waitAll();
+    }
+}
+
+void SurfForecast::invalidateDisplay() {
+    // A single panel always pushes the current frame; on a group only the
+    // panel that is this sensor's display was drawn over
+    for (int i = 0; panels && i < panels->getPanelCount() && i < MAX_CAROUSEL_FRAMES; i++) {
+        if (panels->getPanel(i) == display) locationFrameShown[i] = false;
+    }
+}
+
 // Removed redundant display methods - keeping only displayCurrentConditions()
 
+unsigned long SurfForecast::getTimeUntilUpdate(unsigned long now) const {
+    if (lastUpdate == 0) return 0;
+    // update() runs once more than nextUpdateDelay has passed
+    unsigned long elapsed = now - lastUpdate;
+    return elapsed > nextUpdateDelay ? 0 : nextUpdateDelay - elapsed + 1;
+}
+
 void SurfForecast::update() {
-    static unsigned long lastUpdate = 0;
     unsigned long now = millis();
     
-    // Update using the global refresh interval to sync with display refresh
-    if (now - lastUpdate > REFRESH_INTERVAL_MS || lastUpdate == 0) {
-        // Cycle to next location each refresh
+    // Update using the global refresh interval to sync with display refresh,
+    // or sooner when a failed fetch is due for a retry
+    if (lastUpdate != 0 && now - lastUpdate <= nextUpdateDelay) return;
+    lastUpdate = now;
+    nextUpdateDelay = REFRESH_INTERVAL_MS;
+    
+    // Cycle to next location each refresh, unless the last fetch for this one failed
+    if (retryPending) {
+        retryPending = false;
+    } else {
         nextLocation();
-        
-        Serial.printf("Updating surf forecast data for location %d/%d: %s\n", 
-                     currentLocationIndex + 1, getNumLocations(), 
-                     getSurfLocations()[currentLocationIndex].name.c_str());
-        
-        if (fetchForecastData()) {
-            Serial.println("Surf data updated successfully");
-        } else {
-            Serial.println("Failed to update surf data");
+    }
+    
+    Serial.printf("Updating surf forecast data for location %d/%d: %s\n", 
+                 currentLocationIndex + 1, getNumLocations(), 
+                 getLocation(currentLocationIndex).name);
+    
+    if (isLocationFresh(currentLocationIndex, now)) {
+        // Carousel keeps rotating; the cached frame is still within the polling interval
+        Serial.printf("Forecast is %lu s old (polling every %lu s) - skipping fetch\n",
+                     (now - locationFetchTime[currentLocationIndex]) / 1000, polling.getInterval() / 1000);
+    } else if (!fetchPolicy.allowRequest(now)) {
+        // Outage: the carousel keeps showing the last good frames without using the radio
+        Serial.printf("Fetch circuit open - showing last good data, next probe in %lu s\n",
+                     fetchPolicy.getTimeUntilProbe(now) / 1000);
+    } else if (attemptFetch()) {
+        Serial.println("Surf data updated successfully");
+        recordPollingSample(currentLocationIndex);
+    } else {
+        Serial.println("Failed to update surf data");
+        polling.recordFailure();
+        if (fetchPolicy.getState() == CircuitState::CLOSED) {
+            retryPending = true;
+            nextUpdateDelay = fetchPolicy.getRetryDelay();
         }
-        lastUpdate = now;
     }
 }
 
+bool SurfForecast::attemptFetch() {
+    unsigned long start = millis();
+    bool fetched = fetchForecastData();
+    unsigned long elapsed = millis() - start;
+    
+    if (fetched) {
+        fetchPolicy.recordSuccess();
+    } else {
+        fetchPolicy.recordFailure(millis());
+    }
+    
+    if (telemetry) {
+        telemetry->record("fetch", getLocation(currentLocationIndex).name,
+                          "latency_ms", elapsed,
+                          "ok", fetched ? 1 : 0,
+                          "failures", fetchPolicy.getConsecutiveFailures());
+    }
+    return fetched;
+}
+
+bool SurfForecast::isLocationFresh(int index, unsigned long now) const {
+    if (index >= MAX_CAROUSEL_FRAMES || !locationFrameReady[index]) return false;
+    return now - locationFetchTime[index] < polling.getInterval();
+}
+
+void SurfForecast::recordPollingSample(int index) {
+    if (index >= MAX_CAROUSEL_FRAMES) {
+        polling.recordSample(true);
+        return;
+    }
+
+    // Measured from the last significant height so a slow build still counts as change
+    bool changed = AdaptiveInterval::exceeds(referenceWaveHeight[index], conditions.currentWaveHeight,
+                                             WAVE_HEIGHT_CHANGE_FT);
+    if (changed) {
+        referenceWaveHeight[index] = conditions.currentWaveHeight;
+    }
+    polling.recordSample(changed);
+}
+
 void SurfForecast::nextLocation() {
     currentLocationIndex = (currentLocationIndex + 1) % getNumLocations();
 }
 
-bool SurfForecast::isWiFiConnected() {
-    return WiFi.status() == WL_CONNECTED;
+SurfLocation SurfForecast::getLocation(int slot) const {
+    return catalog.get(rotation[slot]);
 }
 
-// Helper method implementations
-String SurfForecast::getRatingFromHeight(float heightMeters) {
-    float heightFeet = metersToFeet(heightMeters);
+int SurfForecast::getNumLocations() const {
+    return rotationCount;
+}
+
+int SurfForecast::selectNearestSpots(float latitude, float longitude, int count) {
+    if (count > MAX_CAROUSEL_FRAMES) count = MAX_CAROUSEL_FRAMES;
+    catalog.begin();
+    
+    uint32_t indices[MAX_CAROUSEL_FRAMES];
+    float distances[MAX_CAROUSEL_FRAMES];
+    unsigned long start = micros();
+    int found = catalog.findNearest(latitude, longitude, count, indices, distances);
+    unsigned long elapsed = micros() - start;
+    if (!setRotation(indices, found)) return 0;
     
-    if (heightFeet < 1.0) return "FLAT";
-    else if (heightFeet < 2.0) return "SMALL";
-    else if (heightFeet < 4.0) return "GOOD";
-    else if (heightFeet < 6.0) return "GREAT";
-    else if (heightFeet < 8.0) return "EPIC";
-    else return "HUGE";
+    Serial.printf("Nearest %d of %u spots to %.3f, %.3f found in %lu us:\n",
+                 found, (unsigned)catalog.size(), latitude, longitude, elapsed);
+    for (int i = 0; i < found; i++) {
+        Serial.printf("  %d. %-24s %6.1f km\n", i + 1, getLocation(i).name, distances[i]);
+    }
+    return found;
 }
 
-float SurfForecast::metersToFeet(float meters) {
-    return meters * 3.28084;
+bool SurfForecast::setRotation(const uint32_t* indices, int count) {
+    if (count <= 0 || count > MAX_CAROUSEL_FRAMES) return false;
+    for (int i = 0; i < count; i++) {
+        if (indices[i] >= catalog.size()) return false;
+    }
+    
+    // Slots now mean different spots, so nothing cached for them still applies
+    for (int i = 0; i < MAX_CAROUSEL_FRAMES; i++) {
+        if (i < count) rotation[i] = indices[i];
+        locationFrameReady[i] = false;
+        locationFrameShown[i] = false;
+        locationFetchTime[i] = 0;
+        referenceWaveHeight[i] = NAN;
+        ranker.clear(i);
+    }
+    rotationCount = count;
+    currentLocationIndex = 0;
+    retryPending = false;
+    if (rules) rules->reset();
+    return true;
+}
+
+void SurfForecast::setForecastFormat(ForecastFormat newFormat) {
+    format = newFormat;
 }
 
-float SurfForecast::calculateAverage(JsonArray& heights, int startHour, int endHour) {
-    float sum = 0;
-    int count = 0;
+void SurfForecast::rankSessions(int index, const ForecastSeries& series) {
+    if (!TimeUtils::isTimeSynced()) {
+        Serial.println("Clock not set yet - session ranking skipped");
+        return;
+    }
     
-    for (int i = startHour; i < endHour && i < heights.size(); i++) {
-        sum += heights[i].as<float>();
-        count++;
+    // Only this spot's candidates are rescored; the others keep theirs
+    unsigned long start = micros();
+    ranker.update(index, series.heights, series.count, series.startTime, time(nullptr));
+    Serial.printf("Ranked %d hours for %s in %lu us\n", ranker.getLastScoredHours(),
+                 getLocation(index).name, micros() - start);
+    printBestSessions();
+}
+
+void SurfForecast::printBestSessions() {
+    Session best[SESSION_TOP_K];
+    int count = ranker.getTopSessions(best, SESSION_TOP_K, time(nullptr));
+    if (count == 0) {
+        Serial.println("No upcoming sessions match the criteria");
+        return;
     }
     
-    return count > 0 ? sum / count : 0;
+    Serial.println("Best upcoming sessions:");
+    for (int i = 0; i < count; i++) {
+        time_t seconds = (time_t)best[i].time;
+        struct tm local;
+        localtime_r(&seconds, &local);
+        char when[16];
+        strftime(when, sizeof(when), "%a %H:%M", &local);
+        Serial.printf("  %d. %-18s %s  %4.1fft  score %3.0f\n", i + 1, getLocation(best[i].location).name,
+                     when, metersToFeet(best[i].waveHeight), best[i].score);
+    }
+}
+
+void SurfForecast::setPanelGroup(PanelGroup* group) {
+    panels = group;
+}
+
+void SurfForecast::setApiUrl(const String& url) {
+    apiUrl = url;
 }
 
-String SurfForecast::getCurrentTimeString() {
-    // Return the stored UK time from when data was last fetched
-    return lastFetchTime.isEmpty() ? "??:??:??" : lastFetchTime;
+void SurfForecast::setTelemetry(TelemetryPublisher* publisher) {
+    telemetry = publisher;
+}
+
+void SurfForecast::setRuleEngine(RuleEngine* engine) {
+    rules = engine;
+}
+
+bool SurfForecast::isWiFiConnected() {
+    return WiFi.status() == WL_CONNECTED;
+}
+
+// Helper method implementations
+String SurfForecast::getRatingFromHeight(float heightMeters) {
+    return ForecastParser::getRating(heightMeters);
+}
+
+float SurfForecast::metersToFeet(float meters) {
+    return ForecastParser::metersToFeet(meters);
 }
 
 // SensorInterface implementation
@@ -331,3 +691,11 @@ void SurfForecast::displayCurrentData() {
 bool SurfForecast::isDataReady() const {
     return !lastFetchTime.isEmpty() && WiFi.status() == WL_CONNECTED;
 }
+
+bool SurfForecast::hasError() const {
+    return lastFetchFailed;
+}
+
+bool SurfForecast::isDataStale() const {
+    return lastSuccessfulFetch == 0 || millis() - lastSuccessfulFetch > FORECAST_STALE_MS;
+}
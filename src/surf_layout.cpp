@@ -0,0 +1,70 @@
+#include <Arduino.h>
+#include <GxEPD2_BW.h>
+#include "../include/surf_layout.h"
+#include "../include/text_metrics.h"
+
+// Column centerlines and content start for the 3-column layout (296x128 display)
+static constexpr int COL1_CENTER = 48;
+static constexpr int COL2_CENTER = 148;
+static constexpr int COL3_CENTER = 244;
+static constexpr int COL_Y = 40;
+
+// Label positions resolved at compile time from the built-in font metrics
+static constexpr int NOW_LABEL_X = TextMetrics::centeredX(COL1_CENTER, "NOW", 1);
+static constexpr int TODAY_LABEL_X = TextMetrics::centeredX(COL2_CENTER, "TODAY", 1);
+static constexpr int TOMORROW_LABEL_X = TextMetrics::centeredX(COL3_CENTER, "TOMORROW", 1);
+
+void SurfLayout::drawStatic(Adafruit_GFX* gfx) {
+    // Draw horizontal line under header
+    gfx->drawLine(2, 20, 294, 20, GxEPD_BLACK);
+    
+    // Draw vertical separators between columns
+    gfx->drawLine(98, 20, 98, 108, GxEPD_BLACK);   // Between col 1 & 2
+    gfx->drawLine(196, 20, 196, 108, GxEPD_BLACK); // Between col 2 & 3
+    
+    // Column labels
+    gfx->setTextSize(1);
+    gfx->setCursor(NOW_LABEL_X, COL_Y);
+    gfx->print("NOW");
+    
+    gfx->setCursor(TODAY_LABEL_X, COL_Y);
+    gfx->print("TODAY");
+    
+    gfx->setCursor(TOMORROW_LABEL_X, COL_Y);
+    gfx->print("TOMORROW");
+    
+    // Draw horizontal line above footer
+    gfx->drawLine(2, 108, 294, 108, GxEPD_BLACK);
+}
+
+void SurfLayout::drawForecastColumn(Adafruit_GFX* gfx, int center, float waveHeight, const String& rating) {
+    String wave = String(waveHeight, 1);
+    int waveWidth = TextMetrics::width(wave.length(), 2);
+    gfx->setTextSize(2);
+    gfx->setCursor(TextMetrics::centeredX(center, waveWidth), COL_Y + 15);
+    gfx->print(wave);
+    gfx->setTextSize(1);
+    gfx->setCursor(center + waveWidth/2 + 2, COL_Y + 15);
+    gfx->print("ft");
+    
+    gfx->setCursor(TextMetrics::centeredX(center, TextMetrics::width(rating.length(), 1)), COL_Y + 35);
+    gfx->print(rating);
+}
+
+void SurfLayout::drawConditions(Adafruit_GFX* gfx, const SurfConditions& data) {
+    // Header - smaller and more compact (296x128 display)
+    String headerText = "SURF FORECAST @ " + data.location;
+    gfx->setTextSize(1);
+    gfx->setCursor(2, 6);
+    gfx->print(headerText);
+    
+    drawForecastColumn(gfx, COL1_CENTER, data.currentWaveHeight, data.currentRating);
+    drawForecastColumn(gfx, COL2_CENTER, data.todayAverage, data.todayRating);
+    drawForecastColumn(gfx, COL3_CENTER, data.tomorrowAverage, data.tomorrowRating);
+    
+    // Footer - show the UK time when this location's data was fetched
+    String updateText = "Last updated: " + (data.currentTime.isEmpty() ? String("??:??:??") : data.currentTime);
+    gfx->setTextSize(1);
+    gfx->setCursor(2, 114);
+    gfx->print(updateText);
+}
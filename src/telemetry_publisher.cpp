@@ -0,0 +1,190 @@
+#include <Arduino.h>
+#include <time.h>
+#include "../include/telemetry_publisher.h"
+
+TelemetryPublisher::TelemetryPublisher()
+    : port(0), enabled(false), head(0), count(0),
+      packetsSent(0), samplesSent(0), samplesDropped(0) {
+}
+
+void TelemetryPublisher::begin(const char* hostName, uint16_t hostPort, const char* device) {
+    host = hostName ? hostName : "";
+    port = hostPort;
+    deviceId = device ? device : "";
+    enabled = !host.isEmpty() && port != 0;
+
+    if (enabled) {
+        Serial.printf("Telemetry publisher: udp://%s:%u as '%s' (batch %d, queue %d)\n",
+                      host.c_str(), port, deviceId.c_str(), TELEMETRY_BATCH_SIZE, TELEMETRY_QUEUE_CAPACITY);
+    } else {
+        Serial.println("Telemetry publisher disabled (no host configured)");
+    }
+}
+
+void TelemetryPublisher::record(const char* measurement, const char* tag,
+                                const char* name1, float value1,
+                                const char* name2, float value2,
+                                const char* name3, float value3) {
+    if (!enabled) return;
+
+    TelemetrySample sample;
+    time_t now = time(nullptr);
+    sample.timestamp = now > 1600000000 ? (uint32_t)now : 0; // Before 2020 means NTP has not synced
+    sample.queuedAt = millis();
+    sample.measurement = measurement;
+    strlcpy(sample.tag, tag ? tag : "", sizeof(sample.tag));
+
+    const char* names[TELEMETRY_MAX_FIELDS] = {name1, name2, name3};
+    float values[TELEMETRY_MAX_FIELDS] = {value1, value2, value3};
+    sample.fieldCount = 0;
+    for (int i = 0; i < TELEMETRY_MAX_FIELDS; i++) {
+        if (names[i] == nullptr || isnan(values[i])) continue;
+        sample.fieldNames[sample.fieldCount] = names[i];
+        sample.fieldValues[sample.fieldCount] = values[i];
+        sample.fieldCount++;
+    }
+    if (sample.fieldCount == 0) return;
+
+    enqueue(sample);
+}
+
+void TelemetryPublisher::enqueue(const TelemetrySample& sample) {
+    if (count == TELEMETRY_QUEUE_CAPACITY) {
+        // Queue full (long outage) - keep the newest data
+        head = (head + 1) % TELEMETRY_QUEUE_CAPACITY;
+        count--;
+        samplesDropped++;
+    }
+    queue[(head + count) % TELEMETRY_QUEUE_CAPACITY] = sample;
+    count++;
+}
+
+bool TelemetryPublisher::shouldFlush() const {
+    if (count == 0) return false;
+    if (count >= TELEMETRY_BATCH_SIZE) return true;
+    return millis() - queue[head].queuedAt >= TELEMETRY_MAX_BATCH_AGE_MS;
+}
+
+void TelemetryPublisher::loop() {
+    if (!enabled || count == 0) return;
+
+    // Store-and-forward: leave everything queued until the network is back
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    int packets = 0;
+    while (packets < TELEMETRY_MAX_PACKETS_PER_LOOP && shouldFlush()) {
+        if (!sendBatch()) break;
+        packets++;
+    }
+}
+
+bool TelemetryPublisher::sendBatch() {
+    char packet[TELEMETRY_PACKET_SIZE];
+    size_t length = 0;
+    int lines = 0;
+
+    while (lines < count && lines < TELEMETRY_BATCH_SIZE) {
+        const TelemetrySample& sample = queue[(head + lines) % TELEMETRY_QUEUE_CAPACITY];
+        int written = formatLine(packet + length, sizeof(packet) - length, sample);
+        if (written < 0) break; // Packet full, the rest goes in the next batch
+        length += written;
+        lines++;
+    }
+
+    if (lines == 0) {
+        // A single line that cannot fit a packet would block the queue forever
+        Serial.println("Telemetry sample too large for a packet, dropping it");
+        head = (head + 1) % TELEMETRY_QUEUE_CAPACITY;
+        count--;
+        samplesDropped++;
+        return false;
+    }
+
+    if (!udp.beginPacket(host.c_str(), port)) {
+        Serial.printf("Telemetry: cannot resolve %s, keeping %d samples queued\n", host.c_str(), count);
+        return false;
+    }
+    udp.write((const uint8_t*)packet, length);
+    if (!udp.endPacket()) {
+        Serial.printf("Telemetry: send failed, keeping %d samples queued\n", count);
+        return false;
+    }
+
+    head = (head + lines) % TELEMETRY_QUEUE_CAPACITY;
+    count -= lines;
+    packetsSent++;
+    samplesSent += lines;
+
+    Serial.printf("Telemetry: sent %d samples in %u bytes (%d still queued)\n", lines, (unsigned)length, count);
+    return true;
+}
+
+int TelemetryPublisher::formatLine(char* buffer, size_t size, const TelemetrySample& sample) {
+    size_t pos = 0;
+    int n;
+
+    // Measurement and tag set: "surf,device=esp32-lab,location=Sennen\ Cove"
+    n = snprintf(buffer, size, "%s", sample.measurement);
+    if (n < 0 || (size_t)n >= size) return -1;
+    pos += n;
+
+    if (!deviceId.isEmpty()) {
+        n = snprintf(buffer + pos, size - pos, ",device=");
+        if (n < 0 || (size_t)n >= size - pos) return -1;
+        pos += n;
+        n = escapeTag(buffer + pos, size - pos, deviceId.c_str());
+        if (n < 0) return -1;
+        pos += n;
+    }
+
+    if (sample.tag[0] != '\0') {
+        n = snprintf(buffer + pos, size - pos, ",location=");
+        if (n < 0 || (size_t)n >= size - pos) return -1;
+        pos += n;
+        n = escapeTag(buffer + pos, size - pos, sample.tag);
+        if (n < 0) return -1;
+        pos += n;
+    }
+
+    // Field set: " temperature=21.50,humidity=55.00"
+    for (int i = 0; i < sample.fieldCount; i++) {
+        n = snprintf(buffer + pos, size - pos, "%c%s=%.2f",
+                     i == 0 ? ' ' : ',', sample.fieldNames[i], sample.fieldValues[i]);
+        if (n < 0 || (size_t)n >= size - pos) return -1;
+        pos += n;
+    }
+
+    // Timestamp in whole seconds (10 digits, not the default 19 in nanoseconds);
+    // the listener is configured for second precision. None if the clock is not set.
+    if (sample.timestamp == 0) {
+        n = snprintf(buffer + pos, size - pos, "\n");
+    } else {
+        n = snprintf(buffer + pos, size - pos, " %lu\n", (unsigned long)sample.timestamp);
+    }
+    if (n < 0 || (size_t)n >= size - pos) return -1;
+    pos += n;
+
+    return pos;
+}
+
+int TelemetryPublisher::escapeTag(char* buffer, size_t size, const char* value) {
+    // Line protocol requires commas, spaces and equals signs in tag values to be escaped
+    size_t pos = 0;
+    for (const char* c = value; *c != '\0'; c++) {
+        bool special = (*c == ',' || *c == ' ' || *c == '=');
+        if (pos + (special ? 2 : 1) >= size) return -1;
+        if (special) buffer[pos++] = '\\';
+        buffer[pos++] = *c;
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+int TelemetryPublisher::getQueuedCount() const {
+    return count;
+}
+
+void TelemetryPublisher::printStats() const {
+    Serial.printf("Telemetry: %d queued, %lu packets / %lu samples sent, %lu dropped\n",
+                  count, packetsSent, samplesSent, samplesDropped);
+}
@@ -3,17 +3,18 @@
 #include <GxEPD2_BW.h>
 #include "../include/temperature_and_humidity.h"
 #include "../include/time_utils.h"
+#include "../include/energy_monitor.h"
+#include "../include/boot_snapshot.h"
 
 TemperatureHumiditySensor::TemperatureHumiditySensor(EPaperDisplay* displayPtr, int sensorPin, uint8_t sensorType)
-    : display(displayPtr), dhtPin(sensorPin), dhtType(sensorType), initialized(false) {
-    dhtSensor = new DHT(sensorPin, sensorType);
+    : display(displayPtr), telemetry(nullptr), rules(nullptr), dhtSensor(sensorPin, sensorType),
+      dhtPin(sensorPin), dhtType(sensorType), lastUpdateTime(0),
+      sampling("DHT sampling", UPDATE_INTERVAL_MS, UPDATE_INTERVAL_MS, UPDATE_INTERVAL_MAX_MS),
+      referenceTemperature(NAN), referenceHumidity(NAN), initialized(false) {
     currentData = {0.0f, 0.0f, "", true};
 }
 
 TemperatureHumiditySensor::~TemperatureHumiditySensor() {
-    if (dhtSensor) {
-        delete dhtSensor;
-    }
 }
 
 void TemperatureHumiditySensor::begin(const char* ssid, const char* password) {
@@ -35,24 +36,9 @@ void TemperatureHumiditySensor::begin(const char* ssid, const char* password) {
             Serial.println();
             Serial.printf("WiFi connected! IP: %s\n", WiFi.localIP().toString().c_str());
 
-            // Wait for NTP time sync
-            Serial.println("Waiting for NTP time sync...");
-            struct tm timeinfo;
-            attempts = 0;
-            while (!getLocalTime(&timeinfo) && attempts < 10) {
-                delay(1000);
-                attempts++;
-                Serial.print(".");
-            }
-
-            if (attempts < 10) {
-                Serial.println();
-                Serial.printf("Time synchronized: %02d:%02d:%02d\n",
-                             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-            } else {
-                Serial.println();
-                Serial.println("Failed to sync time with NTP");
-            }
+            // SNTP (started in setup) syncs in the background; readings taken
+            // before it completes carry the RTC-seeded or fallback timestamp
+            Serial.printf("Clock source: %s\n", TimeUtils::getTimeSourceName());
         } else {
             Serial.println();
             Serial.println("WiFi connection failed - using fallback timestamps");
@@ -60,7 +46,7 @@ void TemperatureHumiditySensor::begin(const char* ssid, const char* password) {
     }
 
     // Initialize DHT sensor
-    dhtSensor->begin();
+    dhtSensor.begin();
     initialized = true;
 
     Serial.println("DHT11 sensor initialized, performing initial reading...");
@@ -81,16 +67,28 @@ void TemperatureHumiditySensor::update() {
         lastUpdateTime = currentTime;
     }
 
-    if (currentTime - lastUpdateTime >= UPDATE_INTERVAL_MS) {
+    if (currentTime - lastUpdateTime >= sampling.getInterval()) {
         readSensor();
         lastUpdateTime = currentTime;
     }
 }
 
+unsigned long TemperatureHumiditySensor::getTimeUntilUpdate(unsigned long now) const {
+    if (!initialized) return ULONG_MAX;
+    unsigned long elapsed = now - lastUpdateTime;
+    unsigned long interval = sampling.getInterval();
+    return now < lastUpdateTime || elapsed >= interval ? 0 : interval - elapsed;
+}
+
 void TemperatureHumiditySensor::readSensor() {
     // Similar to MicroPython: measure() then read values
-    float temp = dhtSensor->readTemperature(); // Celsius
-    float hum = dhtSensor->readHumidity();
+    float temp;
+    float hum;
+    {
+        EnergyScope acquisition(PowerState::DHT_ACQUISITION);
+        temp = dhtSensor.readTemperature(); // Celsius
+        hum = dhtSensor.readHumidity();
+    }
 
     Serial.printf("DHT11 raw readings - Temp: %.2f, Hum: %.2f\n", temp, hum);
 
@@ -101,9 +99,22 @@ void TemperatureHumiditySensor::readSensor() {
         currentData.temperature = 0.0f;
         currentData.humidity = 0.0f;
         currentData.lastUpdateTime = "ERROR";
+        referenceTemperature = NAN;
+        referenceHumidity = NAN;
+        sampling.recordFailure();
         return;
     }
 
+    // Sample faster while the room is changing, back off while it is flat.
+    // Thresholds are measured from the last significant reading so slow drift still counts.
+    bool changed = AdaptiveInterval::exceeds(referenceTemperature, temp, TEMPERATURE_CHANGE_C) ||
+                   AdaptiveInterval::exceeds(referenceHumidity, hum, HUMIDITY_CHANGE_PERCENT);
+    if (changed) {
+        referenceTemperature = temp;
+        referenceHumidity = hum;
+    }
+    sampling.recordSample(changed);
+
     currentData.temperature = temp;
     currentData.humidity = hum;
     currentData.sensorError = false;
@@ -113,107 +124,79 @@ void TemperatureHumiditySensor::readSensor() {
 
     Serial.printf("Valid sensor reading: %.1f°C, %.1f%% RH at %s\n",
                   temp, hum, currentData.lastUpdateTime.c_str());
+
+    TempHumiditySnapshot snapshot = {temp, hum, ""};
+    strlcpy(snapshot.lastUpdateTime, currentData.lastUpdateTime.c_str(), sizeof(snapshot.lastUpdateTime));
+    BootSnapshot::save("climate", &snapshot, sizeof(snapshot));
+
+    if (telemetry) {
+        telemetry->record("climate", nullptr, "temperature", temp, "humidity", hum);
+    }
+
+    if (rules) {
+        RuleSample sample;
+        sample.set(RuleSignal::TEMPERATURE, temp);
+        sample.set(RuleSignal::HUMIDITY, hum);
+        rules->evaluate(0, "climate", sample, millis());
+    }
 }
 
 void TemperatureHumiditySensor::displayCurrentData() {
-    if (!display || !initialized) return;
+    // Before begin() there is only something to show if a snapshot was restored
+    if (!display || (!initialized && currentData.sensorError)) return;
 
     Serial.println("Updating e-paper display...");
 
-    // Get direct access to the GxEPD2 display for proper paged drawing
-    auto* gxDisplay = display->getDisplay();
-    gxDisplay->setRotation(1); // Landscape orientation
-    gxDisplay->setFullWindow();
-    gxDisplay->firstPage();
-
-    do {
-        gxDisplay->fillScreen(GxEPD_WHITE);
-        gxDisplay->setTextColor(GxEPD_BLACK);
-        gxDisplay->setFont();
-
-        if (currentData.sensorError) {
-            gxDisplay->setTextSize(2);
-            gxDisplay->setCursor(10, 20);
-            gxDisplay->print("Sensor Error!");
-            gxDisplay->setTextSize(1);
-            gxDisplay->setCursor(10, 50);
-            gxDisplay->print("Check connections");
-        } else {
-            // Header - "How moist is our home?"
-            gxDisplay->setTextSize(1.5);
-            gxDisplay->setCursor(2, 6);
-            gxDisplay->print("How moist is our home?");
-
-            // Draw horizontal line under header
-            gxDisplay->drawLine(2, 20, 294, 20, GxEPD_BLACK);
-
-            // Column centerlines for 2-column layout (296px width)
-            // Each column is 148px wide, centered at 74 and 222
-            int col1Center = 74;   // Column 1 centerline (TEMPERATURE) - 296/4
-            int col2Center = 222;  // Column 2 centerline (HUMIDITY) - 296*3/4
-            int colY = 40;         // Start Y position for column content
-
-            // Draw vertical separator between columns at center of display
-            gxDisplay->drawLine(148, 20, 148, 108, GxEPD_BLACK); // Center line at 296/2
-
-            // Column 1 - TEMPERATURE
-            gxDisplay->setTextSize(1);
-            int tempHeaderWidth = display->getTextWidth("TEMPERATURE", 1);
-            gxDisplay->setCursor(col1Center - tempHeaderWidth/2, colY);
-            gxDisplay->print("TEMPERATURE");
-
-            // Temperature value
-            char tempStr[20];
-            sprintf(tempStr, "%.1f", currentData.temperature);
-            int tempValueWidth = display->getTextWidth(tempStr, 3);
-            gxDisplay->setTextSize(3);
-            gxDisplay->setCursor(col1Center - tempValueWidth/2, colY + 15);
-            gxDisplay->print(tempStr);
-
-            // Temperature unit
-            gxDisplay->setTextSize(1);
-            gxDisplay->setCursor(col1Center + tempValueWidth/2 + 2, colY + 15);
-            gxDisplay->print("C");
-
-            // Column 2 - HUMIDITY
-            int humHeaderWidth = display->getTextWidth("HUMIDITY", 1);
-            gxDisplay->setCursor(col2Center - humHeaderWidth/2, colY);
-            gxDisplay->print("HUMIDITY");
-
-            // Humidity value
-            char humStr[20];
-            sprintf(humStr, "%.1f", currentData.humidity);
-            int humValueWidth = display->getTextWidth(humStr, 3);
-            gxDisplay->setTextSize(3);
-            gxDisplay->setCursor(col2Center - humValueWidth/2, colY + 15);
-            gxDisplay->print(humStr);
-
-            // Humidity unit
-            gxDisplay->setTextSize(1);
-            gxDisplay->setCursor(col2Center + humValueWidth/2 + 2, colY + 15);
-            gxDisplay->print("%");
-
-            // Draw horizontal line above footer
-            gxDisplay->drawLine(2, 108, 294, 108, GxEPD_BLACK);
-
-            // Footer - show last updated time (same format as surf forecast)
-            String timeStr = currentData.lastUpdateTime.isEmpty() ? "??:??:?? Unknown Date" :
-                           (currentData.lastUpdateTime.endsWith("s ago") ? currentData.lastUpdateTime : currentData.lastUpdateTime);
-            String updateText = "Last updated: " + timeStr;
-            gxDisplay->setTextSize(1.5);
-            gxDisplay->setCursor(2, 114);
-            gxDisplay->print(updateText);
-        }
-    } while (gxDisplay->nextPage());
+    if (currentData.sensorError) {
+        Adafruit_GFX* gfx = display->beginFrame();
+        gfx->setTextSize(2);
+        gfx->setCursor(10, 20);
+        gfx->print("Sensor Error!");
+        gfx->setTextSize(1);
+        gfx->setCursor(10, 50);
+        gfx->print("Check connections");
+        display->endFrame();
+        Serial.println("E-paper display updated successfully");
+        return;
+    }
 
-    gxDisplay->hibernate();
+    // Header, rules and column labels never change - rasterize them once
+    if (!display->hasStaticLayer()) {
+        ClimateLayout::drawStatic(display->beginStaticLayer());
+        display->endStaticLayer();
+    }
+
+    ClimateLayout::drawReadings(display->beginFrame(true), currentData);
+    display->endFrame();
     Serial.println("E-paper display updated successfully");
 }
 
+bool TemperatureHumiditySensor::restoreSnapshot() {
+    TempHumiditySnapshot snapshot;
+    if (!BootSnapshot::load("climate", &snapshot, sizeof(snapshot))) {
+        Serial.println("No climate snapshot saved");
+        return false;
+    }
+
+    currentData.temperature = snapshot.temperature;
+    currentData.humidity = snapshot.humidity;
+    currentData.lastUpdateTime = snapshot.lastUpdateTime;
+    currentData.sensorError = false;
+    Serial.printf("Restored last reading: %.1f°C, %.1f%% RH at %s\n",
+                  currentData.temperature, currentData.humidity, currentData.lastUpdateTime.c_str());
+
+    displayCurrentData();
+    return true;
+}
+
 bool TemperatureHumiditySensor::isDataReady() const {
     return initialized && !currentData.sensorError && !currentData.lastUpdateTime.isEmpty();
 }
 
+bool TemperatureHumiditySensor::hasError() const {
+    return initialized && currentData.sensorError;
+}
+
 TempHumidityData TemperatureHumiditySensor::getCurrentData() const {
     return currentData;
 }
@@ -221,3 +204,12 @@ TempHumidityData TemperatureHumiditySensor::getCurrentData() const {
 bool TemperatureHumiditySensor::isSensorWorking() const {
     return initialized && !currentData.sensorError;
 }
+
+void TemperatureHumiditySensor::setTelemetry(TelemetryPublisher* publisher) {
+    telemetry = publisher;
+}
+
+void TemperatureHumiditySensor::setRuleEngine(RuleEngine* engine) {
+    rules = engine;
+}
+
@@ -1,9 +1,46 @@
 #include <Arduino.h>
 #include <WiFi.h>
+#include <esp_attr.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+#include <sys/time.h>
 #include "../include/time_utils.h"
 
+// Anything before 2020 means the clock has not been set
+static const time_t MIN_VALID_EPOCH = 1577836800;
+
+// Epoch retained across software resets and watchdog restarts (lost on power-off)
+static const uint32_t RTC_EPOCH_MAGIC = 0x54494D45; // "TIME"
+RTC_NOINIT_ATTR static uint32_t rtcEpochMagic;
+RTC_NOINIT_ATTR static time_t rtcEpoch;
+
+static bool started = false;
+static volatile TimeSource timeSource = TimeSource::NONE;
+
+// Last point where the wall clock was known, used to measure drift at the next sync
+static portMUX_TYPE referenceMux = portMUX_INITIALIZER_UNLOCKED;
+static int64_t referenceEpochUs = 0;
+static int64_t referenceMonoUs = 0;
+
 void TimeUtils::begin() {
-    // Configure NTP for UK time (GMT/BST automatically handled)
+    if (started) return;
+    started = true;
+
+    // The system clock survives deep sleep; after a reset fall back to the retained epoch
+    time_t now = time(nullptr);
+    if (now >= MIN_VALID_EPOCH) {
+        timeSource = TimeSource::RTC;
+        recordReference((int64_t)now * 1000000);
+        Serial.println("Clock still set from before sleep");
+    } else if (rtcEpochMagic == RTC_EPOCH_MAGIC && rtcEpoch >= MIN_VALID_EPOCH) {
+        setClock(rtcEpoch, TimeSource::RTC);
+        Serial.println("Clock seeded from RTC memory (approximate until SNTP sync)");
+    }
+
+    // SNTP runs in the background once WiFi is up. The first sync steps the
+    // clock (a seed can be far off); later ones switch to smooth mode.
+    sntp_set_time_sync_notification_cb(onSntpSync);
+    sntp_set_sync_mode(SNTP_SYNC_MODE_IMMED);
     configTime(0, 3600, "pool.ntp.org", "time.nist.gov"); // UTC+1 for BST
     setenv("TZ", "GMT0BST,M3.5.0/1,M10.5.0", 1);
     tzset();
@@ -11,10 +48,102 @@ void TimeUtils::begin() {
     Serial.println("NTP time sync initialized");
 }
 
+bool TimeUtils::seedFromHttpDate(const String& date) {
+    if (timeSource >= TimeSource::HTTP_DATE || date.isEmpty()) return false;
+
+    time_t epoch = parseHttpDate(date.c_str());
+    if (epoch < MIN_VALID_EPOCH) {
+        Serial.printf("Ignoring unparseable Date header: '%s'\n", date.c_str());
+        return false;
+    }
+
+    setClock(epoch, TimeSource::HTTP_DATE);
+    Serial.printf("Clock seeded from HTTP Date header: %s\n", date.c_str());
+    return true;
+}
+
+void TimeUtils::setClock(time_t epoch, TimeSource source) {
+    struct timeval tv = {epoch, 0};
+    settimeofday(&tv, nullptr);
+    timeSource = source;
+    rtcEpoch = epoch;
+    rtcEpochMagic = RTC_EPOCH_MAGIC;
+    recordReference((int64_t)epoch * 1000000);
+}
+
+void TimeUtils::recordReference(int64_t epochUs) {
+    portENTER_CRITICAL(&referenceMux);
+    referenceEpochUs = epochUs;
+    referenceMonoUs = esp_timer_get_time();
+    portEXIT_CRITICAL(&referenceMux);
+}
+
+void TimeUtils::onSntpSync(struct timeval* tv) {
+    // Runs in the lwIP task - keep it short
+    int64_t syncedUs = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+    int64_t monoNow = esp_timer_get_time();
+
+    portENTER_CRITICAL(&referenceMux);
+    int64_t expectedUs = referenceEpochUs + (monoNow - referenceMonoUs);
+    int64_t elapsedUs = monoNow - referenceMonoUs;
+    bool hadReference = referenceEpochUs != 0;
+    referenceEpochUs = syncedUs;
+    referenceMonoUs = monoNow;
+    portEXIT_CRITICAL(&referenceMux);
+
+    TimeSource previous = timeSource;
+    timeSource = TimeSource::SNTP;
+    if (previous != TimeSource::SNTP) {
+        // From now on slew small corrections with adjtime() so timestamps never jump backwards
+        sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+    }
+    rtcEpoch = tv->tv_sec;
+    rtcEpochMagic = RTC_EPOCH_MAGIC;
+
+    if (!hadReference) {
+        Serial.println("SNTP sync: clock set");
+    } else {
+        // Offset between the clock we were running on and the server, since the last reference
+        int64_t offsetUs = syncedUs - expectedUs;
+        float ppm = elapsedUs > 0 ? offsetUs * 1e6f / elapsedUs : 0.0f;
+        Serial.printf("SNTP sync: %s clock was off by %+lld ms after %lld s (%.1f ppm)\n",
+                      previous == TimeSource::SNTP ? "local" : "seeded",
+                      (long long)(offsetUs / 1000), (long long)(elapsedUs / 1000000), ppm);
+    }
+}
+
+time_t TimeUtils::parseHttpDate(const char* date) {
+    // IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+    static const char* MONTHS = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char monthName[4] = {0};
+    int day, year, hour, minute, second;
+    if (sscanf(date, "%*3s, %d %3s %d %d:%d:%d", &day, monthName, &year, &hour, &minute, &second) != 6) {
+        return 0;
+    }
+
+    const char* found = strstr(MONTHS, monthName);
+    if (found == nullptr || strlen(monthName) != 3 || (found - MONTHS) % 3 != 0) return 0;
+    int month = (found - MONTHS) / 3 + 1;
+
+    // Days since 1970-01-01 for a proleptic Gregorian date (no timegm() in newlib)
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    long days = (long)era * 146097 + dayOfEra - 719468;
+
+    return (time_t)days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
 String TimeUtils::getCurrentTimestamp() {
     struct tm timeinfo;
 
-    if (getLocalTime(&timeinfo)) {
+    if (getLocalTime(&timeinfo, 0)) {
+        // Keep the retained epoch fresh so a reset resumes close to the right time
+        rtcEpoch = time(nullptr);
+        rtcEpochMagic = RTC_EPOCH_MAGIC;
+
         // Format: HH:MM:SS Day DDth Month YYYY with ordinal suffix
         char timeStr[60];
         char dayStr[10];
@@ -46,7 +175,20 @@ String TimeUtils::getOrdinalSuffix(int day) {
 
 bool TimeUtils::isTimeSynced() {
     struct tm timeinfo;
-    return getLocalTime(&timeinfo);
+    return getLocalTime(&timeinfo, 0); // Non-blocking: the default waits up to 5 s
+}
+
+TimeSource TimeUtils::getTimeSource() {
+    return timeSource;
+}
+
+const char* TimeUtils::getTimeSourceName() {
+    switch (timeSource) {
+        case TimeSource::RTC: return "RTC";
+        case TimeSource::HTTP_DATE: return "HTTP Date";
+        case TimeSource::SNTP: return "SNTP";
+        default: return "none";
+    }
 }
 
 String TimeUtils::getFallbackTimestamp() {
@@ -0,0 +1,229 @@
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+// Host build of the parts of Adafruit_GFX the drawing code relies on,
+// transcribed from the library's generic (per-pixel) paths in version 1.11:
+// Bresenham writeLine(), fast lines and fillRect() on top of it, the classic
+// built-in font drawChar()/write() including the CP437 quirk, and the text
+// bounds. The real library can't be built here (it pulls in the SPI/I2C
+// display drivers), and only these paths decide which pixels a frame has.
+// GFX fonts (setFont with a font) are not supported.
+
+#include <Arduino.h>
+#include <glcdfont.c>
+
+#ifndef _swap_int16_t
+#define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
+#endif
+
+typedef struct GFXfont GFXfont;
+
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t w, int16_t h)
+        : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+          textcolor(0xFFFF), textbgcolor(0xFFFF), textsize_x(1), textsize_y(1),
+          rotation(0), wrap(true), _cp437(false), gfxFont(NULL) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void startWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        fillRect(x, y, w, h, color);
+    }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+    virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) {
+            _swap_int16_t(x0, y0);
+            _swap_int16_t(x1, y1);
+        }
+        if (x0 > x1) {
+            _swap_int16_t(x0, x1);
+            _swap_int16_t(y0, y1);
+        }
+        int16_t dx = x1 - x0;
+        int16_t dy = abs(y1 - y0);
+        int16_t err = dx / 2;
+        int16_t ystep = y0 < y1 ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+            if (steep) {
+                writePixel(y0, x0, color);
+            } else {
+                writePixel(x0, y0, color);
+            }
+            err -= dy;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+        }
+    }
+    virtual void endWrite() {}
+
+    virtual void setRotation(uint8_t r) {
+        rotation = r & 3;
+        _width = (rotation & 1) ? HEIGHT : WIDTH;
+        _height = (rotation & 1) ? WIDTH : HEIGHT;
+    }
+
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+        startWrite();
+        writeLine(x, y, x, y + h - 1, color);
+        endWrite();
+    }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+        startWrite();
+        writeLine(x, y, x + w - 1, y, color);
+        endWrite();
+    }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        startWrite();
+        for (int16_t i = x; i < x + w; i++) {
+            writeFastVLine(i, y, h, color);
+        }
+        endWrite();
+    }
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        if (x0 == x1) {
+            if (y0 > y1) _swap_int16_t(y0, y1);
+            drawFastVLine(x0, y0, y1 - y0 + 1, color);
+        } else if (y0 == y1) {
+            if (x0 > x1) _swap_int16_t(x0, x1);
+            drawFastHLine(x0, y0, x1 - x0 + 1, color);
+        } else {
+            startWrite();
+            writeLine(x0, y0, x1, y1, color);
+            endWrite();
+        }
+    }
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                  uint8_t size_x, uint8_t size_y) {
+        if (x >= _width || y >= _height || (x + 6 * size_x - 1) < 0 || (y + 8 * size_y - 1) < 0) return;
+        if (!_cp437 && c >= 176) c++; // Handle 'classic' charset behavior
+
+        startWrite();
+        for (int8_t i = 0; i < 5; i++) {
+            uint8_t line = pgm_read_byte(&font[c * 5 + i]);
+            for (int8_t j = 0; j < 8; j++, line >>= 1) {
+                if (line & 1) {
+                    if (size_x == 1 && size_y == 1) {
+                        writePixel(x + i, y + j, color);
+                    } else {
+                        writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+                    }
+                } else if (bg != color) {
+                    if (size_x == 1 && size_y == 1) {
+                        writePixel(x + i, y + j, bg);
+                    } else {
+                        writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+                    }
+                }
+            }
+        }
+        if (bg != color) { // If opaque, draw vertical line for last column
+            if (size_x == 1 && size_y == 1) {
+                writeFastVLine(x + 5, y, 8, bg);
+            } else {
+                writeFillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+            }
+        }
+        endWrite();
+    }
+
+    using Print::write;
+    virtual size_t write(uint8_t c) {
+        if (c == '\n') {
+            cursor_x = 0;
+            cursor_y += textsize_y * 8;
+        } else if (c != '\r') {
+            if (wrap && (cursor_x + textsize_x * 6) > _width) {
+                cursor_x = 0;
+                cursor_y += textsize_y * 8;
+            }
+            drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+            cursor_x += textsize_x * 6;
+        }
+        return 1;
+    }
+
+    void getTextBounds(const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        uint8_t c;
+        int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+        *x1 = x;
+        *y1 = y;
+        *w = *h = 0;
+        while ((c = *str++)) {
+            charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+        }
+        if (maxx >= minx) {
+            *x1 = minx;
+            *w = maxx - minx + 1;
+        }
+        if (maxy >= miny) {
+            *y1 = miny;
+            *h = maxy - miny + 1;
+        }
+    }
+
+    void setCursor(int16_t x, int16_t y) {
+        cursor_x = x;
+        cursor_y = y;
+    }
+    void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+    void setTextColor(uint16_t c, uint16_t bg) {
+        textcolor = c;
+        textbgcolor = bg;
+    }
+    void setTextSize(uint8_t s) { setTextSize(s, s); }
+    void setTextSize(uint8_t sx, uint8_t sy) {
+        textsize_x = sx > 0 ? sx : 1;
+        textsize_y = sy > 0 ? sy : 1;
+    }
+    void setTextWrap(bool w) { wrap = w; }
+    void cp437(bool x = true) { _cp437 = x; }
+    void setFont(const GFXfont* f = NULL) { gfxFont = (GFXfont*)f; }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+    uint8_t getRotation() const { return rotation; }
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+
+protected:
+    void charBounds(unsigned char c, int16_t* x, int16_t* y, int16_t* minx, int16_t* miny,
+                    int16_t* maxx, int16_t* maxy) {
+        if (c == '\n') {
+            *x = 0;
+            *y += textsize_y * 8;
+        } else if (c != '\r') {
+            if (wrap && (*x + textsize_x * 6) > _width) {
+                *x = 0;
+                *y += textsize_y * 8;
+            }
+            int x2 = *x + textsize_x * 6 - 1;
+            int y2 = *y + textsize_y * 8 - 1;
+            if (x2 > *maxx) *maxx = x2;
+            if (y2 > *maxy) *maxy = y2;
+            if (*x < *minx) *minx = *x;
+            if (*y < *miny) *miny = *y;
+            *x += textsize_x * 6;
+        }
+    }
+
+    const int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    int16_t cursor_x, cursor_y;
+    uint16_t textcolor, textbgcolor;
+    uint8_t textsize_x, textsize_y;
+    uint8_t rotation;
+    bool wrap;
+    bool _cp437;
+    GFXfont* gfxFont;
+};
+
+#endif
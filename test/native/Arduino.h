@@ -0,0 +1,62 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Just enough of the Arduino core for the drawing code (FrameBuffer and the
+// page layouts) to build on the host: integer types, PROGMEM access, Print
+// and a String with the members the layouts use. Not a general replacement.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+class String {
+public:
+    String(const char* text = "") : value(text ? text : "") {}
+    String(float number, unsigned int decimals) {
+        char text[32];
+        snprintf(text, sizeof(text), "%.*f", (int)decimals, number);
+        value = text;
+    }
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    bool endsWith(const String& suffix) const {
+        return value.size() >= suffix.value.size()
+            && value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+    }
+    bool operator==(const String& other) const { return value == other.value; }
+
+    friend String operator+(const String& a, const String& b) { return String((a.value + b.value).c_str()); }
+    friend String operator+(const char* a, const String& b) { return String(a) + b; }
+    friend String operator+(const String& a, const char* b) { return a + String(b); }
+
+private:
+    std::string value;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write((const uint8_t*)text.c_str(), text.length()); }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef NATIVE_GXEPD2_BW_H
+#define NATIVE_GXEPD2_BW_H
+
+// Host build of GxEPD2_BW's frame buffer for the one panel this project uses:
+// a full-window, single-page 1-bpp buffer with the library's drawPixel()
+// rotation mapping and fillScreen(). Everything else Adafruit_GFX draws
+// through drawPixel(), so a page drawn on it is the per-pixel reference for
+// FrameBuffer. There is no controller; buffer() (host only) exposes the bytes
+// writeImage() would send.
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
+
+class GxEPD2_290_BS {
+public:
+    static const uint16_t WIDTH = 128;
+    static const uint16_t HEIGHT = 296;
+};
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+public:
+    GxEPD2_BW() : Adafruit_GFX(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT) {
+        fillScreen(GxEPD_WHITE);
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
+        switch (getRotation()) {
+            case 1:
+                _swap_int16_t(x, y);
+                x = WIDTH - x - 1;
+                break;
+            case 2:
+                x = WIDTH - x - 1;
+                y = HEIGHT - y - 1;
+                break;
+            case 3:
+                _swap_int16_t(x, y);
+                y = HEIGHT - y - 1;
+                break;
+        }
+        uint16_t i = x / 8 + y * (WIDTH / 8);
+        if (color) {
+            _buffer[i] = (_buffer[i] | (1 << (7 - x % 8)));
+        } else {
+            _buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
+        }
+    }
+
+    void fillScreen(uint16_t color) override {
+        memset(_buffer, color == GxEPD_BLACK ? 0x00 : 0xFF, sizeof(_buffer));
+    }
+
+    const uint8_t* buffer() const { return _buffer; }
+
+private:
+    uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+};
+
+#endif
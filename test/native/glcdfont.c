@@ -0,0 +1,271 @@
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+// Stand-in for Adafruit_GFX's built-in 5x7 font: 256 glyphs of 5 column bytes,
+// same layout and guard as the library's glcdfont.c. The glyphs are NOT the
+// real ones - every byte is pseudo-random (fixed seed) so that the host tests,
+// which compare two renderers drawing with the same table, exercise every bit
+// pattern rather than the mostly-empty columns of real characters.
+
+#include <Arduino.h>
+
+static const unsigned char font[] PROGMEM = {
+    0x73, 0x6E, 0xE1, 0xC4, 0x4F,
+    0xE3, 0x5B, 0x59, 0xD6, 0xF3,
+    0x8E, 0xCE, 0xC8, 0x0C, 0x77,
+    0xBC, 0xD9, 0x51, 0xF7, 0xC5,
+    0x40, 0x36, 0x3B, 0x98, 0xFE,
+    0xDE, 0xED, 0xA2, 0xEF, 0x34,
+    0x1C, 0x95, 0x92, 0xCB, 0xEC,
+    0x9A, 0x98, 0x76, 0xFD, 0x55,
+    0x2E, 0xA7, 0x9C, 0x9C, 0x0A,
+    0x88, 0xAC, 0xF7, 0x37, 0xDB,
+    0x52, 0xD7, 0xA1, 0x92, 0x63,
+    0x97, 0x60, 0x2D, 0x8F, 0x33,
+    0xC4, 0xD8, 0x4A, 0xCB, 0x25,
+    0x40, 0x7E, 0xD6, 0x67, 0x39,
+    0xF2, 0x25, 0x4F, 0x11, 0x78,
+    0x9E, 0x89, 0xB1, 0xD9, 0xB6,
+    0x75, 0x79, 0x81, 0xAB, 0xB5,
+    0xD9, 0xEB, 0x87, 0x77, 0xB0,
+    0xCA, 0xD5, 0x83, 0x65, 0xFC,
+    0x20, 0x04, 0xC6, 0x30, 0x2F,
+    0x16, 0xA3, 0x51, 0x03, 0x13,
+    0x29, 0xB9, 0x8D, 0x9D, 0x00,
+    0x17, 0x2F, 0x6B, 0x24, 0x1C,
+    0xF9, 0xD5, 0x84, 0xE8, 0xA0,
+    0x1D, 0x5C, 0x38, 0x3D, 0x83,
+    0x53, 0x4C, 0xCC, 0x07, 0x54,
+    0x99, 0x5F, 0xFC, 0x2C, 0x33,
+    0x25, 0x51, 0xE8, 0xF9, 0x1E,
+    0x9F, 0xEC, 0x7E, 0x9C, 0xF2,
+    0xD4, 0xBA, 0x79, 0x57, 0x0B,
+    0x75, 0x1A, 0x2A, 0x2C, 0x6F,
+    0x26, 0x1C, 0x1B, 0x50, 0x06,
+    0x06, 0xE2, 0x52, 0x1D, 0x71,
+    0x4D, 0xB0, 0xC4, 0xE1, 0x46,
+    0xCE, 0x0C, 0xE6, 0xEE, 0x25,
+    0x33, 0xE0, 0x7F, 0xF4, 0xE2,
+    0x95, 0xE4, 0xA8, 0x2C, 0x74,
+    0x15, 0x08, 0x47, 0xA6, 0x34,
+    0x20, 0x08, 0xDA, 0x69, 0xF3,
+    0x20, 0xCD, 0x7E, 0xE0, 0x19,
+    0x9C, 0x39, 0xD0, 0x0E, 0xC9,
+    0x7D, 0x25, 0x2D, 0x0F, 0x1F,
+    0x62, 0xEE, 0xE6, 0x89, 0x9A,
+    0x10, 0xD4, 0x11, 0x9A, 0x58,
+    0x7A, 0x17, 0xD6, 0x09, 0x5A,
+    0xE1, 0x14, 0x22, 0x69, 0x36,
+    0xDA, 0x5A, 0x58, 0xBC, 0x98,
+    0xDC, 0xA2, 0x12, 0x96, 0xC2,
+    0x56, 0xAC, 0x9C, 0x53, 0xA2,
+    0x72, 0x63, 0xFD, 0x23, 0x18,
+    0xBE, 0x11, 0xEE, 0x3B, 0x88,
+    0x41, 0x5E, 0x41, 0x4C, 0xD9,
+    0x9C, 0xED, 0xB7, 0xC0, 0xEF,
+    0xC4, 0xBE, 0x2E, 0xC9, 0x23,
+    0x8F, 0x2A, 0x8D, 0x1D, 0x39,
+    0xCB, 0x21, 0x16, 0x1A, 0x2B,
+    0x38, 0x21, 0x0C, 0x29, 0x5C,
+    0x19, 0x4F, 0xE7, 0xBE, 0x81,
+    0x34, 0xFF, 0xBE, 0x1C, 0x8F,
+    0x83, 0x38, 0x4C, 0xDA, 0xBB,
+    0x94, 0x2B, 0x29, 0x9E, 0x8C,
+    0x6B, 0xD2, 0x0C, 0xBC, 0xEE,
+    0xD8, 0xD1, 0xEB, 0x24, 0x1C,
+    0x5A, 0x1B, 0x28, 0x42, 0x35,
+    0x52, 0x9A, 0x64, 0x4A, 0x27,
+    0x3A, 0x79, 0xDB, 0x0B, 0x49,
+    0x83, 0x3D, 0x5D, 0xA0, 0x7C,
+    0x54, 0x2C, 0x8D, 0xFE, 0xCF,
+    0xC9, 0x70, 0xB5, 0x29, 0x14,
+    0x1A, 0x85, 0x5B, 0x84, 0xE1,
+    0x7A, 0x61, 0xF3, 0x83, 0x73,
+    0x73, 0x2F, 0xC0, 0x8E, 0x00,
+    0x41, 0xB5, 0x52, 0x6A, 0x7B,
+    0xFA, 0x9F, 0x85, 0x43, 0x7B,
+    0x56, 0xCD, 0xA2, 0x17, 0xC8,
+    0x69, 0x8C, 0xFA, 0xE0, 0xE3,
+    0xED, 0xBB, 0x0F, 0xA5, 0x78,
+    0x34, 0xFA, 0x33, 0x2E, 0x25,
+    0xE6, 0x2A, 0xB0, 0x88, 0xDF,
+    0xFC, 0x46, 0xB2, 0xAC, 0x68,
+    0xAB, 0x2E, 0x72, 0xBC, 0x9E,
+    0x59, 0x2A, 0xCA, 0x29, 0xBD,
+    0xC4, 0xAC, 0xB0, 0x2E, 0x18,
+    0x37, 0xB9, 0xA6, 0x91, 0x40,
+    0x7D, 0xE1, 0x98, 0x91, 0x32,
+    0xB8, 0xC2, 0xA9, 0x16, 0x3F,
+    0xB8, 0x37, 0x3B, 0x9D, 0xEA,
+    0x55, 0x16, 0xAE, 0xF3, 0x85,
+    0xC5, 0x5A, 0xCA, 0x6C, 0x23,
+    0xB3, 0xAE, 0x50, 0x8E, 0xD1,
+    0xD0, 0x53, 0x73, 0x6D, 0xBD,
+    0x6D, 0x9E, 0x40, 0x92, 0x2B,
+    0x43, 0x19, 0xDE, 0x29, 0xCB,
+    0xC1, 0x55, 0x50, 0x60, 0x8F,
+    0x3A, 0xD0, 0x37, 0xC9, 0x8A,
+    0xDC, 0xA0, 0xC1, 0xE9, 0x28,
+    0xCF, 0xAC, 0x4E, 0x24, 0x68,
+    0x41, 0x6D, 0xF5, 0xCC, 0x16,
+    0xE8, 0x38, 0x26, 0xB9, 0x34,
+    0x76, 0x34, 0x91, 0x4C, 0x65,
+    0xD6, 0x73, 0x19, 0xE4, 0x58,
+    0x03, 0x9C, 0xB4, 0x7F, 0xD1,
+    0xE1, 0xF8, 0x55, 0x2F, 0xA4,
+    0x6B, 0xB4, 0xD4, 0xC0, 0x63,
+    0x94, 0x32, 0x5B, 0x89, 0x16,
+    0x97, 0xD3, 0x55, 0x4C, 0x05,
+    0x67, 0x4C, 0xCE, 0xD2, 0xA5,
+    0xF9, 0xFE, 0x00, 0x97, 0xAD,
+    0x16, 0x5A, 0xAD, 0xF6, 0xF6,
+    0x53, 0x69, 0xE0, 0xB0, 0x9E,
+    0xCD, 0xEE, 0xCF, 0x8C, 0x84,
+    0xD6, 0x6B, 0x2A, 0xD2, 0x00,
+    0xED, 0x16, 0x3D, 0xBD, 0xA2,
+    0x25, 0xF9, 0x47, 0x02, 0xB7,
+    0x14, 0x7D, 0xBE, 0xD5, 0x66,
+    0x5B, 0x8C, 0x0F, 0x36, 0x3B,
+    0xB2, 0x17, 0xAD, 0xCD, 0x54,
+    0x1D, 0xFB, 0xD7, 0x7D, 0xEA,
+    0x4B, 0xAD, 0xEE, 0xBC, 0x67,
+    0x70, 0xAA, 0xE4, 0x2B, 0x06,
+    0x3D, 0x20, 0xAB, 0xDD, 0xD0,
+    0xB9, 0x24, 0x5F, 0xEE, 0x5C,
+    0xA3, 0x33, 0x14, 0xB9, 0x77,
+    0x3A, 0xFA, 0xDD, 0x58, 0x44,
+    0xA4, 0x50, 0x54, 0x96, 0x27,
+    0xEE, 0x7D, 0x1C, 0x3C, 0x85,
+    0x54, 0x6E, 0x86, 0x34, 0xF4,
+    0x85, 0xA3, 0x7E, 0xFE, 0x3A,
+    0xF4, 0x31, 0x48, 0x82, 0x2D,
+    0xF9, 0x44, 0x6B, 0x9C, 0xC3,
+    0x32, 0xD5, 0x39, 0xD3, 0x05,
+    0xF1, 0x71, 0xA4, 0x16, 0x7B,
+    0xB2, 0x83, 0x8B, 0xB7, 0xB5,
+    0xEA, 0x86, 0x2D, 0x8F, 0x9D,
+    0x0D, 0x24, 0x77, 0x86, 0xBC,
+    0xDF, 0x55, 0x51, 0x2C, 0x99,
+    0x0F, 0xC7, 0x22, 0x42, 0x92,
+    0xEB, 0x78, 0xF8, 0xA2, 0xD7,
+    0xCB, 0x44, 0x62, 0x54, 0xEA,
+    0x19, 0xA3, 0x3A, 0xF9, 0x8D,
+    0xED, 0x8D, 0x69, 0x54, 0x4E,
+    0x54, 0x98, 0x01, 0xE4, 0x39,
+    0x47, 0xFD, 0x2C, 0xE2, 0xBF,
+    0x43, 0x09, 0x12, 0xC3, 0xE1,
+    0x94, 0x7E, 0x34, 0x2E, 0xA6,
+    0x70, 0x87, 0xCC, 0x26, 0x1D,
+    0xE7, 0x5C, 0x13, 0xC7, 0x29,
+    0x04, 0x50, 0x93, 0x74, 0xA2,
+    0x33, 0x28, 0xAC, 0xCD, 0xCC,
+    0x0B, 0xA3, 0x90, 0xF5, 0xBD,
+    0xFE, 0xE5, 0x1E, 0x91, 0xE9,
+    0xF3, 0xD5, 0x4F, 0x7A, 0x07,
+    0x18, 0x8B, 0xE6, 0x54, 0x5B,
+    0xC2, 0x66, 0x6B, 0x57, 0x39,
+    0xE7, 0x78, 0x99, 0x96, 0x74,
+    0x42, 0xC6, 0x3B, 0x64, 0xE0,
+    0xAE, 0x66, 0x43, 0x3C, 0x18,
+    0x0A, 0x81, 0x49, 0x48, 0x6A,
+    0xDD, 0x04, 0x50, 0x7B, 0x8F,
+    0x2C, 0x1C, 0xF7, 0x38, 0xC0,
+    0x3B, 0x41, 0x8A, 0x3D, 0x6D,
+    0xFC, 0xB7, 0x94, 0xF2, 0x69,
+    0x9A, 0xED, 0x8D, 0x84, 0xA8,
+    0x1E, 0x5A, 0xDE, 0x95, 0xEA,
+    0x55, 0x39, 0xC6, 0xFA, 0xA6,
+    0xE5, 0x79, 0x9B, 0xAE, 0xDD,
+    0xB6, 0x3D, 0xD2, 0xA0, 0xF5,
+    0xA7, 0x0A, 0xD1, 0x8C, 0xFB,
+    0x28, 0x8E, 0xDF, 0x6E, 0xE9,
+    0x90, 0x46, 0xC3, 0xBD, 0x07,
+    0xBC, 0x8C, 0x56, 0x33, 0x4D,
+    0x20, 0xF2, 0xC2, 0x3E, 0x5B,
+    0x69, 0xED, 0xF9, 0x18, 0xF6,
+    0x51, 0xBF, 0x6F, 0xC5, 0x8D,
+    0x0C, 0xAF, 0x40, 0xA1, 0xC9,
+    0x1A, 0x19, 0x01, 0x34, 0x63,
+    0x17, 0x7C, 0x8F, 0xE8, 0xA2,
+    0xD0, 0x8C, 0xAF, 0x0D, 0x09,
+    0x73, 0x22, 0xA5, 0x9E, 0x19,
+    0x8B, 0x7D, 0x49, 0x81, 0x4E,
+    0xF7, 0xAA, 0x4F, 0xE8, 0x13,
+    0x9A, 0xF1, 0xAB, 0x77, 0x50,
+    0x8B, 0x36, 0x42, 0x36, 0xA6,
+    0xB6, 0x91, 0x89, 0x99, 0xE0,
+    0xCD, 0xB3, 0xB3, 0xAA, 0xBB,
+    0x68, 0x2D, 0xCC, 0x41, 0x82,
+    0xD3, 0xFA, 0xF9, 0x9D, 0x6C,
+    0xDE, 0x77, 0x72, 0xEE, 0xD7,
+    0x5B, 0xF4, 0x63, 0x74, 0x15,
+    0x2C, 0x99, 0xAF, 0x7B, 0xD5,
+    0x8C, 0xE9, 0x0C, 0xB7, 0x94,
+    0xA9, 0x02, 0xC4, 0x4F, 0x14,
+    0x19, 0xF4, 0x4C, 0x2C, 0x22,
+    0xE0, 0x7C, 0xC9, 0x46, 0x20,
+    0x59, 0x57, 0x1B, 0x66, 0xD3,
+    0x55, 0x68, 0x57, 0xFF, 0x89,
+    0xB8, 0x2D, 0x7F, 0x03, 0xA1,
+    0x0D, 0xAF, 0xD9, 0xD2, 0x29,
+    0x95, 0x9C, 0xDE, 0x96, 0x85,
+    0x9C, 0xCA, 0xEA, 0x97, 0xE0,
+    0x57, 0x9D, 0xCA, 0xE4, 0x11,
+    0x1D, 0xF5, 0x10, 0x14, 0xAE,
+    0x71, 0xFD, 0xA1, 0x08, 0x88,
+    0x67, 0x64, 0xAE, 0x9C, 0xF0,
+    0x83, 0x10, 0x17, 0x9A, 0x66,
+    0x60, 0x16, 0x02, 0x49, 0x34,
+    0xD4, 0x5D, 0x83, 0xE0, 0xD8,
+    0x34, 0x93, 0x91, 0xDF, 0xDF,
+    0xEF, 0x2A, 0x87, 0xC3, 0x8D,
+    0xDE, 0xC0, 0x4B, 0x2E, 0x92,
+    0xF2, 0xA7, 0x6D, 0xF0, 0xEE,
+    0x47, 0x8B, 0x4B, 0x97, 0x16,
+    0xF7, 0x36, 0x4D, 0x77, 0xA0,
+    0xE2, 0x1C, 0x00, 0xFB, 0x3B,
+    0xA9, 0xF9, 0xD3, 0xC2, 0xD8,
+    0x92, 0xD4, 0x28, 0x3E, 0xE8,
+    0xD5, 0xB0, 0x4A, 0xB6, 0xE9,
+    0x42, 0x32, 0xDB, 0x24, 0x4E,
+    0x9F, 0x90, 0x2D, 0x66, 0x17,
+    0x65, 0x88, 0x9A, 0x2E, 0x00,
+    0xA0, 0x92, 0x6C, 0x95, 0x97,
+    0x6E, 0xFD, 0x24, 0xCE, 0x5E,
+    0x1B, 0x76, 0x33, 0x00, 0x3C,
+    0xD5, 0x4D, 0x7D, 0xFB, 0x8E,
+    0x09, 0x61, 0xC7, 0x27, 0x42,
+    0x3E, 0x4D, 0x61, 0x12, 0x01,
+    0xA6, 0xEC, 0xDB, 0x0F, 0x40,
+    0xED, 0x13, 0x27, 0x8E, 0x30,
+    0xD3, 0xF7, 0x6F, 0x2D, 0x1F,
+    0x7B, 0x5F, 0xBC, 0xF3, 0x19,
+    0x60, 0x98, 0x12, 0x7E, 0xA6,
+    0x95, 0x8E, 0x36, 0x05, 0xA1,
+    0x16, 0x0D, 0x1B, 0x7C, 0x02,
+    0x29, 0x3D, 0x37, 0x20, 0xE4,
+    0x22, 0x6E, 0x3C, 0x6B, 0x52,
+    0x45, 0x71, 0x18, 0x4C, 0x23,
+    0x32, 0x8F, 0x7A, 0x31, 0x18,
+    0x9A, 0xD5, 0x91, 0x69, 0xC5,
+    0x58, 0x5E, 0x6C, 0xB9, 0x26,
+    0x68, 0x6F, 0x59, 0x7A, 0xAC,
+    0x94, 0x9E, 0x52, 0x95, 0x60,
+    0x33, 0xDB, 0xF5, 0x02, 0xCF,
+    0x9B, 0xC2, 0x63, 0x56, 0x61,
+    0x91, 0xF1, 0xAF, 0xEC, 0xD2,
+    0x2B, 0x63, 0x5E, 0xD1, 0xED,
+    0xFB, 0x5F, 0x68, 0x79, 0x16,
+    0x10, 0x85, 0x49, 0x4C, 0xB6,
+    0x5F, 0x97, 0xC6, 0x23, 0x77,
+    0xA8, 0x9A, 0xE4, 0x51, 0xDC,
+    0xE7, 0x2C, 0xEF, 0x77, 0xB4,
+    0x83, 0x12, 0x2D, 0x89, 0x2E,
+    0x30, 0x6F, 0xCB, 0x5D, 0x34,
+    0x78, 0xD8, 0x17, 0xF8, 0x16,
+    0xE7, 0xE6, 0x82, 0x39, 0x9D,
+    0x42, 0x02, 0x3D, 0x6E, 0xBE,
+    0x87, 0xF7, 0xB9, 0xF4, 0x85
+};
+
+#endif
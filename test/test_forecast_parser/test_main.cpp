@@ -0,0 +1,298 @@
+// Host tests for ForecastParser: every fixture in test/fixtures through each
+// entry point the device uses (parse, parseStream plain and gzip, and
+// parseFlatBuffer), checked against the summaries and SurfConditions values
+// tools/make_forecast_fixtures.py printed when it wrote them. Each parse that
+// should succeed is also timed and its allocations counted.
+//
+//     pio test -e native
+//
+// Regenerate the fixtures with tools/make_forecast_fixtures.py and update the
+// tables below from its output if the fixtures ever change.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include <zlib.h>
+#include "../../include/forecast_parser.h"
+
+#ifndef FORECAST_FIXTURE_DIR
+#define FORECAST_FIXTURE_DIR "test/fixtures"
+#endif
+
+static const int64_t FIXTURE_START_TIME = 1767225600;   // 2026-01-01 00:00 UTC
+static const float FEET_TOLERANCE = 0.005f;
+static const size_t READ_CHUNK = 256;                    // Bytes handed over per socket read
+static const double BENCHMARK_SECONDS = 0.05;            // Minimum timed run per fixture
+
+struct Expected {
+    const char* fixture;
+    int location;
+    const char* error;          // Message the parse should fail with, nullptr if it succeeds
+    float currentFeet;
+    float todayFeet;
+    float tomorrowFeet;
+    int hours;
+    int nullHours;
+    const char* currentRating;
+    const char* todayRating;
+    const char* tomorrowRating;
+};
+
+static const Expected JSON_CASES[] = {
+    {"single_1day.json", 0, nullptr, 2.592f, 2.950f, 0.000f, 24, 0, "GOOD", "GOOD", "FLAT"},
+    {"single_7day.json", 0, nullptr, 2.887f, 2.992f, 5.247f, 168, 0, "GOOD", "GOOD", "GREAT"},
+    {"single_16day.json", 0, nullptr, 6.299f, 5.819f, 4.757f, 384, 0, "EPIC", "GREAT", "GREAT"},
+    {"multi_3spots.json", 0, nullptr, 2.592f, 2.950f, 2.053f, 168, 0, "GOOD", "GOOD", "GOOD"},
+    {"multi_3spots.json", 1, nullptr, 2.887f, 2.992f, 5.247f, 168, 0, "GOOD", "GOOD", "GREAT"},
+    {"multi_3spots.json", 2, nullptr, 6.299f, 5.819f, 4.757f, 168, 0, "EPIC", "GREAT", "GREAT"},
+    {"nulls.json", 0, nullptr, 3.084f, 2.618f, 2.286f, 168, 13, "GOOD", "GOOD", "GOOD"},
+    {"multi_3spots.json", 3, "no wave data", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr},
+    {"all_null.json", 0, "wave data is all null", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr},
+    {"missing_wave_height.json", 0, "no wave data", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr},
+    {"truncated.json", 0, "truncated response", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr}
+};
+
+static const Expected GZIP_CASES[] = {
+    {"single_7day.json.gz", 0, nullptr, 2.887f, 2.992f, 5.247f, 168, 0, "GOOD", "GOOD", "GREAT"},
+    {"multi_3spots.json.gz", 0, nullptr, 2.592f, 2.950f, 2.053f, 168, 0, "GOOD", "GOOD", "GOOD"},
+    {"multi_3spots.json.gz", 2, nullptr, 6.299f, 5.819f, 4.757f, 168, 0, "EPIC", "GREAT", "GREAT"},
+    {"nulls.json.gz", 0, nullptr, 3.084f, 2.618f, 2.286f, 168, 13, "GOOD", "GOOD", "GOOD"},
+    {"truncated.json.gz", 0, "truncated response", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr}
+};
+
+static const Expected FLATBUFFER_CASES[] = {
+    {"single_7day.fb", 0, nullptr, 2.887f, 2.992f, 5.247f, 168, 0, "GOOD", "GOOD", "GREAT"},
+    {"single_16day.fb", 0, nullptr, 6.299f, 5.819f, 4.757f, 384, 0, "EPIC", "GREAT", "GREAT"},
+    {"multi_3spots.fb", 0, nullptr, 2.592f, 2.950f, 2.053f, 168, 0, "GOOD", "GOOD", "GOOD"},
+    {"multi_3spots.fb", 1, nullptr, 2.887f, 2.992f, 5.247f, 168, 0, "GOOD", "GOOD", "GREAT"},
+    {"multi_3spots.fb", 2, nullptr, 6.299f, 5.819f, 4.757f, 168, 0, "EPIC", "GREAT", "GREAT"},
+    {"nulls.fb", 0, nullptr, 3.084f, 2.618f, 2.286f, 168, 13, "GOOD", "GOOD", "GOOD"},
+    {"multi_3spots.fb", 3, "no such location", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr},
+    {"missing_wave_height.fb", 0, "no wave data", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr},
+    {"truncated.fb", 0, "truncated response", 0, 0, 0, 0, 0, nullptr, nullptr, nullptr}
+};
+
+// Hands a body to ArduinoJson a chunk at a time, inflating it first if it is
+// gzip, the way InflateStream does on the device
+class ChunkReader {
+public:
+    ChunkReader(const uint8_t* body, size_t bodyLength, bool gzipped)
+        : data(body), length(bodyLength), position(0), gzip(gzipped), finished(false) {
+        memset(&inflater, 0, sizeof(inflater));
+        if (gzip) inflateInit2(&inflater, 16 + MAX_WBITS);   // 16: expect a gzip header
+    }
+
+    ~ChunkReader() {
+        if (gzip) inflateEnd(&inflater);
+    }
+
+    int read() {
+        char c;
+        return readBytes(&c, 1) == 1 ? (unsigned char)c : -1;
+    }
+
+    size_t readBytes(char* buffer, size_t size) {
+        if (!gzip) {
+            size_t count = length - position;
+            if (count > size) count = size;
+            if (count > READ_CHUNK) count = READ_CHUNK;
+            memcpy(buffer, data + position, count);
+            position += count;
+            return count;
+        }
+
+        inflater.next_out = (Bytef*)buffer;
+        inflater.avail_out = size;
+        while (!finished && inflater.avail_out == size) {
+            if (inflater.avail_in == 0) {
+                if (position == length) break;              // Body ended early
+                size_t count = length - position < READ_CHUNK ? length - position : READ_CHUNK;
+                inflater.next_in = (Bytef*)(data + position);
+                inflater.avail_in = count;
+                position += count;
+            }
+            int status = inflate(&inflater, Z_NO_FLUSH);
+            if (status != Z_OK) finished = true;            // Stream end or corrupt data
+        }
+        return size - inflater.avail_out;
+    }
+
+private:
+    const uint8_t* data;
+    size_t length;
+    size_t position;
+    bool gzip;
+    bool finished;
+    z_stream inflater;
+};
+
+enum class Path { PARSE, STREAM, GZIP_STREAM, FLATBUFFER };
+
+static const char* getPathName(Path path) {
+    switch (path) {
+        case Path::PARSE: return "parse";
+        case Path::STREAM: return "parseStream";
+        case Path::GZIP_STREAM: return "parseStream+gzip";
+        default: return "parseFlatBuffer";
+    }
+}
+
+static uint8_t* loadFixture(const char* name, size_t& length) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", FORECAST_FIXTURE_DIR, name);
+    FILE* file = fopen(path, "rb");
+    if (!file) return nullptr;
+
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* body = (uint8_t*)malloc(length ? length : 1);
+    if (body && fread(body, 1, length, file) != length) {
+        free(body);
+        body = nullptr;
+    }
+    fclose(file);
+    return body;
+}
+
+static bool runParse(Path path, const uint8_t* body, size_t length, int location, ForecastSummary& summary,
+                     const char** error, CountingAllocator& allocator, ForecastSeries* series) {
+    switch (path) {
+        case Path::PARSE:
+            return ForecastParser::parse((const char*)body, length, summary, error, &allocator, location, series);
+        case Path::STREAM:
+        case Path::GZIP_STREAM: {
+            ChunkReader reader(body, length, path == Path::GZIP_STREAM);
+            return ForecastParser::parseStream(reader, summary, error, &allocator, location, series);
+        }
+        default:
+            return ForecastParser::parseFlatBuffer(body, length, summary, error, location, series);
+    }
+}
+
+// Repeat the parse for at least BENCHMARK_SECONDS and report body MB/s, with
+// the document's peak memory and allocation count for a single parse
+static void benchmark(Path path, const Expected& expected, const uint8_t* body, size_t length) {
+    ForecastSummary summary;
+    const char* error = nullptr;
+    CountingAllocator allocator;
+    runParse(path, body, length, expected.location, summary, &error, allocator, nullptr);
+    size_t peakBytes = allocator.getPeakBytes();
+    size_t allocations = allocator.getAllocationCount();
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    double seconds = 0;
+    unsigned long runs = 0;
+    while (seconds < BENCHMARK_SECONDS) {
+        runParse(path, body, length, expected.location, summary, &error, allocator, nullptr);
+        runs++;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    printf("  %-18s %-22s #%d %6u bytes %8.1f MB/s %6u bytes peak %3u allocations\n",
+           getPathName(path), expected.fixture, expected.location, (unsigned)length,
+           (double)length * runs / seconds / 1e6, (unsigned)peakBytes, (unsigned)allocations);
+}
+
+static void checkCase(Path path, const Expected& expected) {
+    char context[96];
+    snprintf(context, sizeof(context), "%s %s #%d", getPathName(path), expected.fixture, expected.location);
+
+    size_t length = 0;
+    uint8_t* body = loadFixture(expected.fixture, length);
+    TEST_ASSERT_NOT_NULL_MESSAGE(body, context);
+
+    ForecastSummary summary;
+    const char* error = nullptr;
+    float heights[400];
+    ForecastSeries series = {heights, 400, 0, 0};
+    CountingAllocator allocator;
+    bool parsed = runParse(path, body, length, expected.location, summary, &error, allocator, &series);
+
+    if (expected.error) {
+        TEST_ASSERT_FALSE_MESSAGE(parsed, context);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.error, error, context);
+        TEST_ASSERT_EQUAL_UINT_MESSAGE(0, allocator.getCurrentBytes(), context);
+        free(body);
+        return;
+    }
+
+    TEST_ASSERT_TRUE_MESSAGE(parsed, context);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected.hours, summary.hours, context);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected.nullHours, summary.nullHours, context);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected.hours, series.count, context);
+    TEST_ASSERT_TRUE_MESSAGE(series.startTime == FIXTURE_START_TIME, context);
+    TEST_ASSERT_TRUE_MESSAGE(isnan(heights[0]) == (expected.nullHours > 0), context);
+
+    // What SurfConditions would show
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FEET_TOLERANCE, expected.currentFeet,
+                                     ForecastParser::metersToFeet(summary.currentHeight), context);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FEET_TOLERANCE, expected.todayFeet,
+                                     ForecastParser::metersToFeet(summary.todayAverage), context);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FEET_TOLERANCE, expected.tomorrowFeet,
+                                     ForecastParser::metersToFeet(summary.tomorrowAverage), context);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.currentRating, ForecastParser::getRating(summary.currentHeight), context);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.todayRating, ForecastParser::getRating(summary.todayAverage), context);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.tomorrowRating, ForecastParser::getRating(summary.tomorrowAverage),
+                                     context);
+
+    // The document is freed when the parse returns
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(0, allocator.getCurrentBytes(), context);
+
+    benchmark(path, expected, body, length);
+    free(body);
+}
+
+template <size_t N>
+static void checkCases(Path path, const Expected (&cases)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        checkCase(path, cases[i]);
+    }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_parse_json() {
+    checkCases(Path::PARSE, JSON_CASES);
+}
+
+void test_parse_stream_json() {
+    checkCases(Path::STREAM, JSON_CASES);
+}
+
+void test_parse_stream_gzip() {
+    checkCases(Path::GZIP_STREAM, GZIP_CASES);
+}
+
+void test_parse_flatbuffer() {
+    checkCases(Path::FLATBUFFER, FLATBUFFER_CASES);
+}
+
+void test_rating_scale() {
+    // Boundaries in feet, converted back to metres just either side
+    TEST_ASSERT_EQUAL_STRING("FLAT", ForecastParser::getRating(0.0f));
+    TEST_ASSERT_EQUAL_STRING("FLAT", ForecastParser::getRating(0.99f / 3.28084f));
+    TEST_ASSERT_EQUAL_STRING("SMALL", ForecastParser::getRating(1.01f / 3.28084f));
+    TEST_ASSERT_EQUAL_STRING("GOOD", ForecastParser::getRating(2.01f / 3.28084f));
+    TEST_ASSERT_EQUAL_STRING("GREAT", ForecastParser::getRating(4.01f / 3.28084f));
+    TEST_ASSERT_EQUAL_STRING("EPIC", ForecastParser::getRating(6.01f / 3.28084f));
+    TEST_ASSERT_EQUAL_STRING("HUGE", ForecastParser::getRating(8.01f / 3.28084f));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rating_scale);
+    RUN_TEST(test_parse_json);
+    RUN_TEST(test_parse_stream_json);
+    RUN_TEST(test_parse_stream_gzip);
+    RUN_TEST(test_parse_flatbuffer);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+// Host tests for FrameBuffer's span rasterizer: random scenes of rectangles,
+// fast and diagonal lines and built-in font text (sizes 1-6, separate x/y
+// sizes, opaque and transparent, wrapping on and off, control and CP437
+// characters, partly or wholly off-screen) drawn on a FrameBuffer and on a
+// GxEPD2_BW buffer, which gets every pixel through Adafruit_GFX's generic
+// per-pixel paths. The two frames must be byte-identical. Also times a full
+// surf page on each and prints the speedup.
+//
+//     pio test -e native
+//
+// The reference is the transcription of Adafruit_GFX 1.11 and GxEPD2_BW in
+// test/native, and the font is the pseudo-random table there, not the real
+// glyphs. The timings are host timings, a guide to the ratio on the device
+// rather than a measurement of it.
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "../../include/frame_buffer.h"
+#include "../../include/surf_layout.h"
+
+typedef GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> ReferenceDisplay;
+
+static const int SCENES = 3000;
+static const int OPERATIONS_PER_SCENE = 30;
+static const double BENCHMARK_SECONDS = 0.2;             // Minimum timed run per renderer
+
+static uint8_t frameStorage[FrameBuffer::BUFFER_SIZE];
+static ReferenceDisplay reference;
+
+// Small LCG so the scenes are the same on every host
+class SceneRandom {
+public:
+    explicit SceneRandom(uint32_t seed) : state(seed) {}
+
+    int between(int low, int high) {
+        state = state * 1103515245u + 12345u;
+        return low + (int)((state >> 8) % (uint32_t)(high - low + 1));
+    }
+
+private:
+    uint32_t state;
+};
+
+// One random drawing call; the same seed gives the same call on either target
+static void drawRandom(Adafruit_GFX& gfx, uint32_t seed) {
+    SceneRandom random(seed);
+    uint16_t color = random.between(0, 1) ? GxEPD_BLACK : GxEPD_WHITE;
+    switch (random.between(0, 5)) {
+        case 0: {
+            int16_t x = random.between(-40, 320), y = random.between(-40, 320);
+            int16_t w = random.between(-5, 80), h = random.between(-5, 80);
+            gfx.fillRect(x, y, w, h, color);
+            break;
+        }
+        case 1: {
+            int16_t x = random.between(-40, 320), y = random.between(-40, 320);
+            gfx.drawFastHLine(x, y, random.between(-5, 120), color);
+            break;
+        }
+        case 2: {
+            int16_t x = random.between(-40, 320), y = random.between(-40, 320);
+            gfx.drawFastVLine(x, y, random.between(-5, 120), color);
+            break;
+        }
+        case 3: {
+            int16_t x0 = random.between(-20, 310), y0 = random.between(-20, 310);
+            int16_t x1 = random.between(-20, 310), y1 = random.between(-20, 310);
+            gfx.drawLine(x0, y0, x1, y1, color);
+            break;
+        }
+        case 4: {
+            // Axis-aligned drawLine, in either direction
+            int16_t x = random.between(-20, 300), y = random.between(-20, 300);
+            if (random.between(0, 1)) {
+                gfx.drawLine(x, y, x, random.between(-20, 300), color);
+            } else {
+                gfx.drawLine(x, y, random.between(-20, 300), y, color);
+            }
+            break;
+        }
+        default: {
+            if (random.between(0, 1)) {
+                gfx.setTextSize(random.between(1, 6));
+            } else {
+                uint8_t sizeX = random.between(1, 5);
+                gfx.setTextSize(sizeX, random.between(1, 5));
+            }
+            if (random.between(0, 1)) {
+                gfx.setTextColor(color);
+            } else {
+                gfx.setTextColor(color, random.between(0, 1) ? GxEPD_BLACK : GxEPD_WHITE);
+            }
+            gfx.setTextWrap(random.between(0, 1));
+            int16_t x = random.between(-30, 300);
+            gfx.setCursor(x, random.between(-30, 300));
+            char text[12];
+            for (int i = 0; i < 11; i++) {
+                text[i] = (char)random.between(1, 255);
+            }
+            text[random.between(1, 11)] = 0;
+            gfx.print(text);
+            break;
+        }
+    }
+}
+
+void test_random_scenes_match_per_pixel() {
+    FrameBuffer frame(frameStorage);
+    SceneRandom rotations(1);
+    int mismatches = 0;
+    for (int scene = 0; scene < SCENES; scene++) {
+        // Mostly landscape, which is what the device draws in and what the fast glyph path covers
+        uint8_t rotation = scene % 5 == 4 ? rotations.between(0, 3) : 1;
+        frame.setRotation(rotation);
+        reference.setRotation(rotation);
+        frame.fillScreen(GxEPD_WHITE);
+        reference.fillScreen(GxEPD_WHITE);
+
+        for (int op = 0; op < OPERATIONS_PER_SCENE; op++) {
+            uint32_t seed = (uint32_t)scene * 1000u + op;
+            drawRandom(frame, seed);
+            drawRandom(reference, seed);
+        }
+        if (memcmp(frame.getBuffer(), reference.buffer(), FrameBuffer::BUFFER_SIZE) != 0) {
+            if (mismatches++ < 5) printf("  Scene %d (rotation %u) differs\n", scene, rotation);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, mismatches, "scenes where FrameBuffer and the per-pixel path differ");
+}
+
+// Draw the whole surf page (chrome and values, no static layer) for at least
+// BENCHMARK_SECONDS and return microseconds per page
+static double timeSurfPage(Adafruit_GFX& gfx, void (*beginPage)(Adafruit_GFX&)) {
+    static const SurfConditions conditions =
+        {3.25f, 12.04f, 0.3f, "GOOD", "HUGE", "FLAT", "12:03:44 Sunday 18th October 2026", "Cribbar, Newquay"};
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    double seconds = 0;
+    unsigned long pages = 0;
+    while (seconds < BENCHMARK_SECONDS) {
+        beginPage(gfx);
+        SurfLayout::drawStatic(&gfx);
+        SurfLayout::drawConditions(&gfx, conditions);
+        pages++;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return seconds * 1e6 / pages;
+}
+
+static void beginReferencePage(Adafruit_GFX& gfx) {
+    gfx.setRotation(1);
+    gfx.fillScreen(GxEPD_WHITE);
+    gfx.setTextColor(GxEPD_BLACK);
+    gfx.setTextSize(1);
+}
+
+static void beginFramePage(Adafruit_GFX& gfx) {
+    static_cast<FrameBuffer&>(gfx).beginPage(nullptr);
+}
+
+void test_surf_page_benchmark() {
+    FrameBuffer frame(frameStorage);
+    double perPixel = timeSurfPage(reference, beginReferencePage);
+    double spans = timeSurfPage(frame, beginFramePage);
+    printf("  Surf page: per-pixel %.2f us, FrameBuffer %.2f us (%.1fx)\n", perPixel, spans, perPixel / spans);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, memcmp(frame.getBuffer(), reference.buffer(), FrameBuffer::BUFFER_SIZE),
+                                  "benchmark pages differ");
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_random_scenes_match_per_pixel);
+    RUN_TEST(test_surf_page_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,232 @@
+// Golden-frame tests for the page layouts: each deployment's page drawn the
+// way the device draws it now (static layer rasterized once into a
+// FrameBuffer, copied under every frame, values drawn on top) must be
+// byte-identical to the same page drawn the way it was before the static
+// layer existed - the whole page per frame through Adafruit_GFX's per-pixel
+// paths on a GxEPD2_BW buffer, with getTextWidth() centering.
+//
+//     pio test -e native
+//
+// The host Adafruit_GFX and GxEPD2_BW are the transcriptions in test/native,
+// and the font there is a pseudo-random table rather than the real glyphs,
+// so what is checked is that both renderers set the same bits, not what the
+// characters look like.
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "../../include/frame_buffer.h"
+#include "../../include/surf_layout.h"
+#include "../../include/climate_layout.h"
+
+typedef GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> ReferenceDisplay;
+
+static uint8_t frameStorage[FrameBuffer::BUFFER_SIZE];
+static uint8_t layerStorage[FrameBuffer::BUFFER_SIZE];
+
+// EPaperDisplay::getTextWidth() as it was, side effects on the display included
+static int referenceTextWidth(ReferenceDisplay* gxDisplay, const char* text, int textSize) {
+    gxDisplay->setFont();
+    gxDisplay->setTextSize(textSize);
+    int16_t x1, y1;
+    uint16_t w, h;
+    gxDisplay->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+    return w;
+}
+
+// The surf page as SurfForecast::displayCurrentConditions() drew it, one page
+// pass. The footer takes the per-location fetch time the layout shows now.
+static void drawReferenceSurf(ReferenceDisplay* gxDisplay, const SurfConditions& conditions) {
+    gxDisplay->setRotation(1);
+    gxDisplay->fillScreen(GxEPD_WHITE);
+    gxDisplay->setTextColor(GxEPD_BLACK);
+    gxDisplay->setFont();
+
+    String headerText = "SURF FORECAST @ " + conditions.location;
+    gxDisplay->setTextSize(1);
+    gxDisplay->setCursor(2, 6);
+    gxDisplay->print(headerText);
+    gxDisplay->drawLine(2, 20, 294, 20, GxEPD_BLACK);
+
+    int col1Center = 48;
+    int col2Center = 148;
+    int col3Center = 244;
+    int colY = 40;
+    gxDisplay->drawLine(98, 20, 98, 108, GxEPD_BLACK);
+    gxDisplay->drawLine(196, 20, 196, 108, GxEPD_BLACK);
+
+    const char* labels[] = {"NOW", "TODAY", "TOMORROW"};
+    const int centers[] = {col1Center, col2Center, col3Center};
+    const float heights[] = {conditions.currentWaveHeight, conditions.todayAverage, conditions.tomorrowAverage};
+    const String* ratings[] = {&conditions.currentRating, &conditions.todayRating, &conditions.tomorrowRating};
+    gxDisplay->setTextSize(1);
+    for (int column = 0; column < 3; column++) {
+        int center = centers[column];
+        int labelWidth = referenceTextWidth(gxDisplay, labels[column], 1);
+        gxDisplay->setCursor(center - labelWidth/2, colY);
+        gxDisplay->print(labels[column]);
+
+        String wave = String(heights[column], 1);
+        int waveWidth = referenceTextWidth(gxDisplay, wave.c_str(), 2);
+        gxDisplay->setTextSize(2);
+        gxDisplay->setCursor(center - waveWidth/2, colY + 15);
+        gxDisplay->print(wave);
+        gxDisplay->setTextSize(1);
+        gxDisplay->setCursor(center + waveWidth/2 + 2, colY + 15);
+        gxDisplay->print("ft");
+
+        int ratingWidth = referenceTextWidth(gxDisplay, ratings[column]->c_str(), 1);
+        gxDisplay->setCursor(center - ratingWidth/2, colY + 35);
+        gxDisplay->print(*ratings[column]);
+    }
+
+    gxDisplay->drawLine(2, 108, 294, 108, GxEPD_BLACK);
+    String updateText = "Last updated: " + (conditions.currentTime.isEmpty() ? String("??:??:??") : conditions.currentTime);
+    gxDisplay->setCursor(2, 114);
+    gxDisplay->print(updateText);
+}
+
+// The climate page as TemperatureHumiditySensor::displayCurrentData() drew it
+static void drawReferenceClimate(ReferenceDisplay* gxDisplay, const TempHumidityData& currentData) {
+    gxDisplay->setRotation(1);
+    gxDisplay->fillScreen(GxEPD_WHITE);
+    gxDisplay->setTextColor(GxEPD_BLACK);
+    gxDisplay->setFont();
+
+    gxDisplay->setTextSize(1.5);
+    gxDisplay->setCursor(2, 6);
+    gxDisplay->print("How moist is our home?");
+    gxDisplay->drawLine(2, 20, 294, 20, GxEPD_BLACK);
+
+    int col1Center = 74;
+    int col2Center = 222;
+    int colY = 40;
+    gxDisplay->drawLine(148, 20, 148, 108, GxEPD_BLACK);
+
+    gxDisplay->setTextSize(1);
+    int tempHeaderWidth = referenceTextWidth(gxDisplay, "TEMPERATURE", 1);
+    gxDisplay->setCursor(col1Center - tempHeaderWidth/2, colY);
+    gxDisplay->print("TEMPERATURE");
+
+    char tempStr[20];
+    sprintf(tempStr, "%.1f", currentData.temperature);
+    int tempValueWidth = referenceTextWidth(gxDisplay, tempStr, 3);
+    gxDisplay->setTextSize(3);
+    gxDisplay->setCursor(col1Center - tempValueWidth/2, colY + 15);
+    gxDisplay->print(tempStr);
+    gxDisplay->setTextSize(1);
+    gxDisplay->setCursor(col1Center + tempValueWidth/2 + 2, colY + 15);
+    gxDisplay->print("C");
+
+    int humHeaderWidth = referenceTextWidth(gxDisplay, "HUMIDITY", 1);
+    gxDisplay->setCursor(col2Center - humHeaderWidth/2, colY);
+    gxDisplay->print("HUMIDITY");
+
+    char humStr[20];
+    sprintf(humStr, "%.1f", currentData.humidity);
+    int humValueWidth = referenceTextWidth(gxDisplay, humStr, 3);
+    gxDisplay->setTextSize(3);
+    gxDisplay->setCursor(col2Center - humValueWidth/2, colY + 15);
+    gxDisplay->print(humStr);
+    gxDisplay->setTextSize(1);
+    gxDisplay->setCursor(col2Center + humValueWidth/2 + 2, colY + 15);
+    gxDisplay->print("%");
+
+    gxDisplay->drawLine(2, 108, 294, 108, GxEPD_BLACK);
+    String timeStr = currentData.lastUpdateTime.isEmpty() ? "??:??:?? Unknown Date" : currentData.lastUpdateTime;
+    String updateText = "Last updated: " + timeStr;
+    gxDisplay->setTextSize(1.5);
+    gxDisplay->setCursor(2, 114);
+    gxDisplay->print(updateText);
+}
+
+// EPaperDisplay::beginStaticLayer()/endStaticLayer(): the chrome on a blank
+// page, kept as the layer every frame starts from
+static FrameBuffer& rasterizeStaticLayer(void (*drawStatic)(Adafruit_GFX*)) {
+    static FrameBuffer frame(frameStorage);
+    frame.beginPage(nullptr);
+    drawStatic(&frame);
+    frame.copyTo(layerStorage);
+    return frame;
+}
+
+static void assertSameFrame(const ReferenceDisplay& reference, const FrameBuffer& frame, const char* label) {
+    int differing = 0;
+    for (size_t i = 0; i < FrameBuffer::BUFFER_SIZE; i++) {
+        if (reference.buffer()[i] != frame.getBuffer()[i]) differing++;
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "%s: %d of %u bytes differ", label, differing, (unsigned)FrameBuffer::BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, differing, message);
+}
+
+static const SurfConditions SURF_CASES[] = {
+    {0.3f, 3.25f, 12.04f, "FLAT", "GOOD", "HUGE", "", "Cribbar, Newquay"},
+    {3.25f, 12.04f, 0.3f, "GOOD", "HUGE", "FLAT", "12:03:44 Sunday 18th October 2026", "Sennen Cove"},
+    {12.04f, 0.3f, 3.25f, "HUGE", "FLAT", "GOOD", "06:30:00 Monday 19th October 2026", "Croyde Bay"},
+    {0.0f, 0.0f, 0.0f, "FLAT", "FLAT", "FLAT", "23:59:59 Wednesday 31st December 2025", "Gwithian"},
+    {25.9f, 18.5f, 9.99f, "HUGE", "HUGE", "EPIC", "00:00:00 Thursday 1st January 2026",
+     "A spot name long enough to run past the right edge"},
+};
+
+static const TempHumidityData CLIMATE_CASES[] = {
+    {21.4f, 55.25f, "14:22:10 Sunday 18th October 2026", false},
+    {-5.0f, 100.0f, "", false},
+    {9.95f, 7.0f, "12s ago", false},
+    {30.0f, 63.3f, "07:01:02 Tuesday 20th October 2026", false},
+    {-12.75f, 0.0f, "18:45:00 Friday 25th December 2026", false},
+};
+
+void test_surf_page_matches_full_redraw() {
+    FrameBuffer& frame = rasterizeStaticLayer(SurfLayout::drawStatic);
+    for (size_t i = 0; i < sizeof(SURF_CASES) / sizeof(SURF_CASES[0]); i++) {
+        frame.beginPage(layerStorage);
+        SurfLayout::drawConditions(&frame, SURF_CASES[i]);
+
+        static ReferenceDisplay reference;
+        drawReferenceSurf(&reference, SURF_CASES[i]);
+        assertSameFrame(reference, frame, SURF_CASES[i].location.c_str());
+    }
+}
+
+void test_climate_page_matches_full_redraw() {
+    FrameBuffer& frame = rasterizeStaticLayer(ClimateLayout::drawStatic);
+    for (size_t i = 0; i < sizeof(CLIMATE_CASES) / sizeof(CLIMATE_CASES[0]); i++) {
+        frame.beginPage(layerStorage);
+        ClimateLayout::drawReadings(&frame, CLIMATE_CASES[i]);
+
+        static ReferenceDisplay reference;
+        drawReferenceClimate(&reference, CLIMATE_CASES[i]);
+        char label[32];
+        snprintf(label, sizeof(label), "%.2f C / %.2f %%", CLIMATE_CASES[i].temperature, CLIMATE_CASES[i].humidity);
+        assertSameFrame(reference, frame, label);
+    }
+}
+
+// The static layer must not be blank, or the tests above would prove little
+void test_static_layers_have_content() {
+    void (*layouts[])(Adafruit_GFX*) = {SurfLayout::drawStatic, ClimateLayout::drawStatic};
+    for (size_t i = 0; i < 2; i++) {
+        rasterizeStaticLayer(layouts[i]);
+        int black = 0;
+        for (size_t j = 0; j < FrameBuffer::BUFFER_SIZE; j++) {
+            black += __builtin_popcount((uint8_t)~layerStorage[j]);
+        }
+        printf("Static layer %u: %d black pixels\n", (unsigned)i, black);
+        TEST_ASSERT_GREATER_THAN_INT(500, black);
+    }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_surf_page_matches_full_redraw);
+    RUN_TEST(test_climate_page_matches_full_redraw);
+    RUN_TEST(test_static_layers_have_content);
+    return UNITY_END();
+}
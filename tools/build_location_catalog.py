@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Build the binary surf-spot catalog for the "catalog" flash partition.
+
+Input is a CSV with name, latitude and longitude columns (a header row is
+optional). Spots are bucketed into a latitude/longitude grid, sorted by cell
+and written with a cell index so the device can find the spots nearest to a
+position by looking at a few cells, straight from memory-mapped flash.
+The layout matches CatalogHeader/CatalogCell/CatalogSpot in
+include/location_catalog.h.
+
+    tools/build_location_catalog.py tools/surf_spots.csv catalog.bin
+    parttool.py --port /dev/ttyUSB0 write_partition --partition-name catalog --input catalog.bin
+
+(or esptool.py write_flash at the catalog offset in partitions.csv).
+"""
+
+import argparse
+import csv
+import math
+import struct
+import sys
+
+VERSION = 1
+HEADER = struct.Struct("<4sHHIIIfIIIII")
+CELL = struct.Struct("<III")
+SPOT = struct.Struct("<ffI")
+PARTITION_SIZE = 0x100000  # Must match partitions.csv
+
+
+def fnv1a(data):
+    value = 2166136261
+    for byte in data:
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def read_spots(path):
+    spots = []
+    with open(path, newline="", encoding="utf-8") as handle:
+        for line, row in enumerate(csv.reader(handle), 1):
+            if not row or row[0].startswith("#"):
+                continue
+            if line == 1 and row[0].strip().lower() == "name":
+                continue
+            if len(row) < 3:
+                sys.exit("%s:%d: expected name,latitude,longitude" % (path, line))
+            name = row[0].strip()
+            try:
+                latitude, longitude = float(row[1]), float(row[2])
+            except ValueError:
+                sys.exit("%s:%d: bad coordinates" % (path, line))
+            if not (-90 <= latitude <= 90 and -180 <= longitude <= 180):
+                sys.exit("%s:%d: coordinates out of range" % (path, line))
+            spots.append((name, latitude, longitude))
+    return spots
+
+
+def f32(value):
+    return struct.unpack("<f", struct.pack("<f", value))[0]
+
+
+def build(spots, cell_size):
+    # Grid arithmetic in float32 like LocationCatalog, so spots on a cell boundary agree
+    size = f32(cell_size)
+    rows = math.ceil(f32(180 / size))
+    columns = math.ceil(f32(360 / size))
+
+    def key(latitude, longitude):
+        row = min(max(int(math.floor(f32(f32(f32(latitude) + 90) / size))), 0), rows - 1)
+        column = int(math.floor(f32(f32(f32(longitude) + 180) / size))) % columns
+        return row * columns + column
+
+    ordered = sorted(spots, key=lambda s: (key(s[1], s[2]), s[0]))
+
+    names = bytearray()
+    name_offsets = {}
+    spot_table = bytearray()
+    cells = []
+    for index, (name, latitude, longitude) in enumerate(ordered):
+        if name not in name_offsets:
+            name_offsets[name] = len(names)
+            names += name.encode("utf-8") + b"\0"
+        spot_table += SPOT.pack(latitude, longitude, name_offsets[name])
+        cell = key(latitude, longitude)
+        if cells and cells[-1][0] == cell:
+            cells[-1][2] += 1
+        else:
+            cells.append([cell, index, 1])
+    if not names:
+        names = bytearray(b"\0")
+
+    cell_table = b"".join(CELL.pack(*cell) for cell in cells)
+    cells_offset = HEADER.size
+    spots_offset = cells_offset + len(cell_table)
+    names_offset = spots_offset + len(spot_table)
+    body = cell_table + bytes(spot_table) + bytes(names)
+    body += b"\0" * (-len(body) % 4)
+    total = HEADER.size + len(body)
+
+    header = HEADER.pack(b"SPOT", VERSION, HEADER.size, total, len(ordered), len(cells), cell_size,
+                         cells_offset, spots_offset, names_offset, len(names), fnv1a(body))
+    return header + body, len(cells)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("csv", help="name,latitude,longitude per line")
+    parser.add_argument("output", help="catalog image to write")
+    parser.add_argument("--cell-size", type=float, default=0.5, help="grid cell size in degrees (default 0.5)")
+    options = parser.parse_args()
+
+    if not 0 < options.cell_size <= 90:
+        parser.error("cell size must be in (0, 90]")
+
+    spots = read_spots(options.csv)
+    image, cell_count = build(spots, options.cell_size)
+    if len(image) > PARTITION_SIZE:
+        sys.exit("catalog is %d bytes, the partition holds %d" % (len(image), PARTITION_SIZE))
+
+    with open(options.output, "wb") as handle:
+        handle.write(image)
+    print("%d spots in %d cells, %d bytes (%.1f%% of the partition)"
+          % (len(spots), cell_count, len(image), 100.0 * len(image) / PARTITION_SIZE))
+
+
+if __name__ == "__main__":
+    main()
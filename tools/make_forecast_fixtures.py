@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Regenerate the forecast parser fixtures in test/fixtures.
+
+Writes Open-Meteo marine responses in every shape the device parses (JSON,
+gzip JSON and size-prefixed FlatBuffers, built with the same code as the
+marine API stand-in) plus the edge cases: 1 to 16 days, several locations,
+null hours, a missing wave_height series and truncated bodies. The data is
+deterministic, so rerunning it only changes the fixtures if this script does.
+
+Prints the summary each fixture should produce, in the units SurfConditions
+shows (feet and rating), for the table in test/test_forecast_parser.
+
+    tools/make_forecast_fixtures.py [--out test/fixtures]
+"""
+
+import argparse
+import gzip
+import json
+import math
+import os
+
+from marine_api_standin import FlatBuilder, flatbuffers_location, json_location
+
+START = 1767225600  # 2026-01-01 00:00 UTC
+SPOTS = [
+    (50.425998, -5.103096),  # Cribbar, Newquay
+    (50.079780, -5.698678),  # Sennen Cove
+    (50.229620, -5.394250),  # Gwithian
+]
+
+# Same windows and scale as forecast_parser.h and ForecastParser::getRating
+TODAY = (1, 12)
+TOMORROW = (24, 36)
+RATINGS = [(1.0, "FLAT"), (2.0, "SMALL"), (4.0, "GOOD"), (6.0, "GREAT"), (8.0, "EPIC")]
+
+
+def heights(latitude, longitude, hours):
+    """The stand-in's swell curve, for any length of series."""
+    phase = (latitude * 7.0 + longitude * 3.0) % (2 * math.pi)
+    series = []
+    for hour in range(hours):
+        t = (START // 3600 + hour) / 24.0
+        height = 1.2 + 0.6 * math.sin(2 * math.pi * t / 5.0 + phase) + 0.25 * math.sin(2 * math.pi * t * 2 + phase)
+        series.append(round(max(height, 0.1), 2))
+    return series
+
+
+def with_nulls(series, hours):
+    return [None if i in hours else h for i, h in enumerate(series)]
+
+
+def average(series, window):
+    points = [h for h in series[window[0]:window[1]] if h is not None]
+    return sum(points) / len(points) if points else 0.0
+
+
+def rating(meters):
+    feet = meters * 3.28084
+    for limit, name in RATINGS:
+        if feet < limit:
+            return name
+    return "HUGE"
+
+
+def expected(series):
+    current = next((h for h in series if h is not None), 0.0)
+    today = average(series, TODAY)
+    tomorrow = average(series, TOMORROW)
+    return (current * 3.28084, today * 3.28084, tomorrow * 3.28084, len(series),
+            sum(1 for h in series if h is None), rating(current), rating(today), rating(tomorrow))
+
+
+def json_body(locations):
+    documents = [json_location(lat, lon, START, series) for lat, lon, series in locations]
+    return json.dumps(documents[0] if len(documents) == 1 else documents, separators=(",", ":")).encode()
+
+
+def flat_body(locations):
+    # None becomes NaN, which is how the FlatBuffers format marks a missing value
+    return b"".join(flatbuffers_location(lat, lon, START, [math.nan if h is None else h for h in series])
+                    for lat, lon, series in locations)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--out", default=os.path.join(os.path.dirname(__file__), "..", "test", "fixtures"))
+    options = parser.parse_args()
+    os.makedirs(options.out, exist_ok=True)
+
+    cribbar, sennen, gwithian = SPOTS
+    one_day = [(cribbar[0], cribbar[1], heights(cribbar[0], cribbar[1], 24))]
+    week = [(sennen[0], sennen[1], heights(sennen[0], sennen[1], 168))]
+    sixteen_days = [(gwithian[0], gwithian[1], heights(gwithian[0], gwithian[1], 384))]
+    three_spots = [(lat, lon, heights(lat, lon, 168)) for lat, lon in SPOTS]
+    gappy = [(cribbar[0], cribbar[1],
+              with_nulls(heights(cribbar[0], cribbar[1], 168), {0, 1, 2, 5, 6, 7, 8, 24, 25, 26, 27, 28, 29}))]
+    all_null = [(cribbar[0], cribbar[1], [None] * 48)]
+
+    missing = json_location(cribbar[0], cribbar[1], START, heights(cribbar[0], cribbar[1], 24))
+    del missing["hourly"]["wave_height"]
+    missing_body = json.dumps(missing, separators=(",", ":")).encode()
+
+    # The FlatBuffers equivalent of a missing series: hourly with no variables
+    builder = FlatBuilder()
+    builder.table("root", [(0, "f32", cribbar[0]), (1, "f32", cribbar[1]), (11, "hourly", None)])
+    builder.table("hourly", [(0, "i64", START), (3, "variables", None)])
+    builder.offset_vector("variables", [])
+    missing_flat = builder.finish()
+
+    bodies = {
+        "single_1day.json": json_body(one_day),
+        "single_7day.json": json_body(week),
+        "single_16day.json": json_body(sixteen_days),
+        "multi_3spots.json": json_body(three_spots),
+        "nulls.json": json_body(gappy),
+        "all_null.json": json_body(all_null),
+        "missing_wave_height.json": missing_body,
+        "truncated.json": json_body(week)[:len(json_body(week)) // 2],
+        "single_7day.fb": flat_body(week),
+        "single_16day.fb": flat_body(sixteen_days),
+        "multi_3spots.fb": flat_body(three_spots),
+        "nulls.fb": flat_body(gappy),
+        "missing_wave_height.fb": missing_flat,
+        "truncated.fb": flat_body(week)[:len(flat_body(week)) // 2],
+    }
+    # mtime=0 keeps the gzip bytes stable between runs
+    for name in ("single_7day.json", "multi_3spots.json", "nulls.json"):
+        bodies[name + ".gz"] = gzip.compress(bodies[name], mtime=0)
+    compressed = gzip.compress(bodies["single_7day.json"], mtime=0)
+    bodies["truncated.json.gz"] = compressed[:len(compressed) // 2]
+
+    for name, body in sorted(bodies.items()):
+        with open(os.path.join(options.out, name), "wb") as f:
+            f.write(body)
+        print("%-26s %7d bytes" % (name, len(body)))
+
+    print("\nExpected (feet current/today/tomorrow, hours, null hours, ratings):")
+    for label, locations in (("single_1day", one_day), ("single_7day", week), ("single_16day", sixteen_days),
+                             ("multi_3spots", three_spots), ("nulls", gappy)):
+        for index, (_, _, series) in enumerate(locations):
+            values = expected(series)
+            print('%-14s %d  %.3ff, %.3ff, %.3ff, %d, %d, "%s", "%s", "%s"' % ((label, index) + values))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,320 @@
+#!/usr/bin/env python3
+"""Local stand-in for the Open-Meteo marine API with fault injection.
+
+Serves synthetic hourly wave heights in the same shapes the device parses
+(JSON, or size-prefixed FlatBuffers with format=flatbuffers; gzip when the
+client accepts it) and can inject latency, HTTP errors, dropped connections,
+hangs and truncated bodies, so the fetch policy can be watched under failure.
+
+Point a surf build at it with, in platformio.ini:
+
+    build_flags = ... -DFORECAST_API_URL=\\"http://<this-host>:8080/v1/marine\\"
+
+Example: half a second of latency, 20% 503s and 10% truncated bodies:
+
+    tools/marine_api_standin.py --latency-ms 500 --error-rate 0.2 --truncate-rate 0.1
+
+A summary of the outcomes served is printed on Ctrl-C (or SIGTERM).
+"""
+
+import argparse
+import gzip
+import json
+import math
+import random
+import signal
+import socket
+import struct
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+HOURS = 168
+
+# Field slots in the openmeteo_sdk schema (weather_api.fbs)
+RESPONSE_LATITUDE = 0
+RESPONSE_LONGITUDE = 1
+RESPONSE_HOURLY = 11
+SERIES_TIME = 0
+SERIES_TIME_END = 1
+SERIES_INTERVAL = 2
+SERIES_VARIABLES = 3
+VARIABLE_VALUES = 3
+
+
+def wave_heights(latitude, longitude, start):
+    """Deterministic swell per spot: a slow tidal-ish cycle on a multi-day trend."""
+    phase = (latitude * 7.0 + longitude * 3.0) % (2 * math.pi)
+    heights = []
+    for hour in range(HOURS):
+        t = (start // 3600 + hour) / 24.0
+        height = 1.2 + 0.6 * math.sin(2 * math.pi * t / 5.0 + phase) + 0.25 * math.sin(2 * math.pi * t * 2 + phase)
+        heights.append(round(max(height, 0.1), 2))
+    return heights
+
+
+def json_location(latitude, longitude, start, heights):
+    return {
+        "latitude": latitude,
+        "longitude": longitude,
+        "utc_offset_seconds": 0,
+        "timezone": "GMT",
+        "hourly_units": {"time": "unixtime", "wave_height": "m"},
+        "hourly": {
+            "time": [start + 3600 * i for i in range(len(heights))],
+            "wave_height": heights,
+        },
+    }
+
+
+class FlatBuilder:
+    """Just enough of a FlatBuffers writer for the fields the device reads.
+
+    Tables are laid out front to back with their vtable immediately before
+    them; uoffsets always point forward and are patched once targets exist.
+    """
+
+    def __init__(self):
+        self.buf = bytearray(b"\0" * 4)  # Root uoffset
+        self.patches = []                # (position, label)
+        self.labels = {}
+        self.patches.append((0, "root"))
+
+    def align(self, size):
+        while len(self.buf) % size:
+            self.buf.append(0)
+
+    def table(self, label, fields):
+        """fields: list of (slot, kind, value); kind is f32, i32, i64 or an offset label."""
+        slots = max(slot for slot, _, _ in fields) + 1
+        layout = []
+        offset = 4  # After the soffset to the vtable
+        for slot, kind, value in sorted(fields, key=lambda f: f[1] != "i64"):
+            size = 8 if kind == "i64" else 4
+            offset = (offset + size - 1) // size * size
+            layout.append((slot, kind, value, offset))
+            offset += size
+        table_size = offset
+
+        self.align(4)
+        vtable = len(self.buf)
+        entries = [0] * slots
+        for slot, _, _, field_offset in layout:
+            entries[slot] = field_offset
+        self.buf += struct.pack("<HH", 4 + 2 * slots, table_size)
+        self.buf += b"".join(struct.pack("<H", e) for e in entries)
+        self.align(8)
+
+        start = len(self.buf)
+        self.labels[label] = start
+        self.buf += struct.pack("<i", start - vtable)
+        self.buf += b"\0" * (table_size - 4)
+        for slot, kind, value, field_offset in layout:
+            position = start + field_offset
+            if kind == "f32":
+                struct.pack_into("<f", self.buf, position, value)
+            elif kind == "i32":
+                struct.pack_into("<i", self.buf, position, value)
+            elif kind == "i64":
+                struct.pack_into("<q", self.buf, position, value)
+            else:
+                self.patches.append((position, kind))
+
+    def offset_vector(self, label, targets):
+        self.align(4)
+        self.labels[label] = len(self.buf)
+        self.buf += struct.pack("<I", len(targets))
+        for target in targets:
+            self.patches.append((len(self.buf), target))
+            self.buf += b"\0" * 4
+
+    def float_vector(self, label, values):
+        self.align(4)
+        self.labels[label] = len(self.buf)
+        self.buf += struct.pack("<I", len(values))
+        self.buf += b"".join(struct.pack("<f", v) for v in values)
+
+    def finish(self):
+        for position, label in self.patches:
+            struct.pack_into("<I", self.buf, position, self.labels[label] - position)
+        return struct.pack("<I", len(self.buf)) + bytes(self.buf)
+
+
+def flatbuffers_location(latitude, longitude, start, heights):
+    builder = FlatBuilder()
+    builder.table("root", [
+        (RESPONSE_LATITUDE, "f32", latitude),
+        (RESPONSE_LONGITUDE, "f32", longitude),
+        (RESPONSE_HOURLY, "hourly", None),
+    ])
+    builder.table("hourly", [
+        (SERIES_TIME, "i64", start),
+        (SERIES_TIME_END, "i64", start + 3600 * len(heights)),
+        (SERIES_INTERVAL, "i32", 3600),
+        (SERIES_VARIABLES, "variables", None),
+    ])
+    builder.offset_vector("variables", ["wave_height"])
+    builder.table("wave_height", [(VARIABLE_VALUES, "values", None)])
+    builder.float_vector("values", heights)
+    return builder.finish()
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.counts = {}
+
+    def add(self, outcome):
+        with self.lock:
+            self.counts[outcome] = self.counts.get(outcome, 0) + 1
+
+    def summary(self):
+        with self.lock:
+            total = sum(self.counts.values())
+            parts = ", ".join("%s %d" % item for item in sorted(self.counts.items()))
+        return "%d requests: %s" % (total, parts or "none")
+
+
+def make_handler(options, stats, rng):
+    class Handler(BaseHTTPRequestHandler):
+        # HTTP/1.0 like the device asks for: no chunking, connection closes after the body
+        protocol_version = "HTTP/1.0"
+
+        def log_message(self, fmt, *args):
+            if not options.quiet:
+                BaseHTTPRequestHandler.log_message(self, fmt, *args)
+
+        def pick_fault(self):
+            with stats.lock:
+                roll = rng.random()
+            for name, rate in (("drop", options.drop_rate), ("hang", options.hang_rate),
+                               ("error", options.error_rate), ("truncate", options.truncate_rate)):
+                if roll < rate:
+                    return name
+                roll -= rate
+            return None
+
+        def do_GET(self):
+            url = urlparse(self.path)
+            if url.path != options.path:
+                self.send_error(404)
+                stats.add("not_found")
+                return
+
+            with stats.lock:
+                delay = options.latency_ms + rng.uniform(0, options.jitter_ms)
+            time.sleep(delay / 1000.0)
+
+            fault = self.pick_fault()
+            if fault == "drop":
+                # Reset instead of a clean close so the client sees an error, not an empty body
+                self.connection.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+                self.close_connection = True
+                stats.add("dropped")
+                self.log_message("dropped connection")
+                return
+            if fault == "hang":
+                stats.add("hung")
+                self.log_message("hanging for %.0f s", options.hang_s)
+                time.sleep(options.hang_s)
+                return
+            if fault == "error":
+                self.send_error(options.error_status)
+                stats.add("error_%d" % options.error_status)
+                return
+
+            query = parse_qs(url.query)
+            try:
+                latitudes = [float(v) for v in query["latitude"][0].split(",")]
+                longitudes = [float(v) for v in query["longitude"][0].split(",")]
+            except (KeyError, ValueError):
+                self.send_error(400, "latitude and longitude are required")
+                stats.add("bad_request")
+                return
+            if len(latitudes) != len(longitudes):
+                self.send_error(400, "latitude and longitude counts differ")
+                stats.add("bad_request")
+                return
+
+            start = int(time.time()) // 3600 * 3600
+            flatbuffers = query.get("format", ["json"])[0] == "flatbuffers"
+            if flatbuffers:
+                body = b"".join(flatbuffers_location(lat, lon, start, wave_heights(lat, lon, start))
+                                for lat, lon in zip(latitudes, longitudes))
+                content_type = "application/octet-stream"
+            else:
+                locations = [json_location(lat, lon, start, wave_heights(lat, lon, start))
+                             for lat, lon in zip(latitudes, longitudes)]
+                document = locations[0] if len(locations) == 1 else locations
+                body = json.dumps(document, separators=(",", ":")).encode()
+                content_type = "application/json"
+
+            gzipped = not options.no_gzip and "gzip" in self.headers.get("Accept-Encoding", "")
+            if gzipped:
+                body = gzip.compress(body)
+
+            self.send_response(200)
+            self.send_header("Content-Type", content_type)
+            self.send_header("Content-Length", str(len(body)))
+            if gzipped:
+                self.send_header("Content-Encoding", "gzip")
+            self.end_headers()
+
+            if fault == "truncate":
+                # Full Content-Length promised, then the connection closes partway
+                self.wfile.write(body[:len(body) // 2])
+                self.close_connection = True
+                stats.add("truncated")
+                self.log_message("truncated body at %d of %d bytes", len(body) // 2, len(body))
+                return
+
+            self.wfile.write(body)
+            stats.add("ok")
+
+    return Handler
+
+
+def stop(signum, frame):
+    raise KeyboardInterrupt
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--path", default="/v1/marine")
+    parser.add_argument("--latency-ms", type=float, default=0, help="delay before every response")
+    parser.add_argument("--jitter-ms", type=float, default=0, help="extra random delay, uniform in [0, jitter]")
+    parser.add_argument("--error-rate", type=float, default=0, help="fraction answered with --error-status")
+    parser.add_argument("--error-status", type=int, default=503)
+    parser.add_argument("--truncate-rate", type=float, default=0, help="fraction whose body stops halfway")
+    parser.add_argument("--drop-rate", type=float, default=0, help="fraction reset without a response")
+    parser.add_argument("--hang-rate", type=float, default=0, help="fraction that never answer")
+    parser.add_argument("--hang-s", type=float, default=120, help="how long a hung request is held")
+    parser.add_argument("--no-gzip", action="store_true", help="ignore Accept-Encoding")
+    parser.add_argument("--seed", type=int, default=None, help="make the fault sequence repeatable")
+    parser.add_argument("--quiet", action="store_true", help="only print the final summary")
+    options = parser.parse_args()
+
+    rates = options.drop_rate + options.hang_rate + options.error_rate + options.truncate_rate
+    if rates > 1:
+        parser.error("fault rates add up to more than 1")
+
+    stats = Stats()
+    server = ThreadingHTTPServer((options.host, options.port), make_handler(options, stats, random.Random(options.seed)))
+    server.daemon_threads = True
+    signal.signal(signal.SIGINT, stop)
+    signal.signal(signal.SIGTERM, stop)
+    print("Marine API stand-in on http://%s:%d%s" % (options.host, options.port, options.path), flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+        print(stats.summary(), flush=True)
+
+
+if __name__ == "__main__":
+    main()